@@ -100,28 +100,84 @@ std::set<Zstring, LessNativePath> waitForMissingDirs(const std::vector<Zstring>&
 }
 
 
-//wait until changes are detected or if a directory is not available (anymore)
-DirWatcher::Change waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths, //throw FileError
-                                  const std::function<void(bool readyForSync)>& requestUiUpdate, std::chrono::milliseconds cbInterval)
+using DirWatches = std::vector<std::pair<Zstring /*folderPath*/, std::unique_ptr<DirWatcher>>>;
+
+
+bool isIgnoredChange(const DirWatcher::Change& change)
 {
-    assert(std::all_of(folderPaths.begin(), folderPaths.end(), [](const Zstring& folderPath) { return dirAvailable(folderPath); }));
-    if (folderPaths.empty()) //pathological case, but we have to check else this function will wait endlessly
-        throw FileError(_("A folder input field is empty.")); //should have been checked by caller!
+    return
+        endsWith(change.itemPath, Zstr(".ffs_tmp"))  || //sync.8ea2.ffs_tmp
+        endsWith(change.itemPath, Zstr(".ffs_lock")) || //sync.ffs_lock, sync.Del.ffs_lock
+        endsWith(change.itemPath, Zstr(".ffs_db"));     //sync.ffs_db
+    //no need to ignore temporary recycle bin directory: this must be caused by a file deletion anyway
+}
+
+
+//extract accumulated changes of all watches; ChangeType::baseFolderUnavailable takes precedence
+std::vector<DirWatcher::Change> fetchChanges(DirWatches& watches, //throw FileError
+                                             const std::function<void()>& requestUiUpdate, std::chrono::milliseconds cbInterval)
+{
+    std::vector<DirWatcher::Change> output;
+
+    for (const auto& [folderPath, watcher] : watches)
+        try
+        {
+            std::vector<DirWatcher::Change> changes = watcher->fetchChanges(requestUiUpdate, cbInterval); //throw FileError
+
+            for (const DirWatcher::Change& change : changes)
+                if (change.type == DirWatcher::ChangeType::baseFolderUnavailable)
+                    return {change};
+
+            std::erase_if(changes, isIgnoredChange);
+            append(output, changes);
+        }
+        catch (FileError&)
+        {
+            if (!dirAvailable(folderPath)) //a benign(?) race condition with FileError
+                return {{DirWatcher::ChangeType::baseFolderUnavailable, folderPath}};
+            throw;
+        }
+    return output;
+}
 
-    std::vector<std::pair<Zstring, std::unique_ptr<DirWatcher>>> watches;
 
+/* (re-)install watches: required after directory structure changes, see DirWatcher
+    => incremental comparison: no change must get lost => install new watches *before* discarding the old ones and return their remaining changes */
+std::vector<DirWatcher::Change> renewWatches(DirWatches& watches, const std::set<Zstring, LessNativePath>& folderPaths, //throw FileError
+                                             const std::function<void()>& requestUiUpdate, std::chrono::milliseconds cbInterval)
+{
+    DirWatches watchesNew;
     for (const Zstring& folderPath : folderPaths)
         try
         {
-            watches.emplace_back(folderPath, std::make_unique<DirWatcher>(folderPath)); //throw FileError
+            watchesNew.emplace_back(folderPath, std::make_unique<DirWatcher>(folderPath)); //throw FileError
         }
         catch (FileError&)
         {
             if (!dirAvailable(folderPath)) //folder not existing or can't access
-                return {DirWatcher::ChangeType::baseFolderUnavailable, folderPath};
+                return {{DirWatcher::ChangeType::baseFolderUnavailable, folderPath}};
             throw;
         }
 
+    std::vector<DirWatcher::Change> changes = fetchChanges(watches, requestUiUpdate, cbInterval); //throw FileError
+    watches.swap(watchesNew);
+    return changes;
+}
+
+
+//wait until changes are detected or if a directory is not available (anymore)
+std::vector<DirWatcher::Change> waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths, DirWatches& watches, //throw FileError
+                                               const std::function<void(bool readyForSync)>& requestUiUpdate, std::chrono::milliseconds cbInterval)
+{
+    assert(std::all_of(folderPaths.begin(), folderPaths.end(), [](const Zstring& folderPath) { return dirAvailable(folderPath); }));
+    if (folderPaths.empty()) //pathological case, but we have to check else this function will wait endlessly
+        throw FileError(_("A folder input field is empty.")); //should have been checked by caller!
+
+    if (watches.empty())
+        if (std::vector<DirWatcher::Change> changes = renewWatches(watches, folderPaths, [&] { requestUiUpdate(false /*readyForSync*/); /*throw X*/ }, cbInterval); //throw FileError
+            !changes.empty()) //=> baseFolderUnavailable
+            return changes;
+
     auto lastCheckTime = std::chrono::steady_clock::now();
     for (;;)
     {
@@ -136,40 +192,18 @@ DirWatcher::Change waitForChanges(const std::set<Zstring, LessNativePath>& folde
             return false;
         }();
 
-        for (const auto& [folderPath, watcher] : watches)
-        {
-            //IMPORTANT CHECK: DirWatcher has problems detecting removal of top watched directories!
-            if (checkDirNow)
+        //IMPORTANT CHECK: DirWatcher has problems detecting removal of top watched directories!
+        if (checkDirNow)
+            for (const auto& [folderPath, watcher] : watches)
                 if (!dirAvailable(folderPath)) //catch errors related to directory removal, e.g. ERROR_NETNAME_DELETED
-                    return {DirWatcher::ChangeType::baseFolderUnavailable, folderPath};
-            try
-            {
-                std::vector<DirWatcher::Change> changes = watcher->fetchChanges([&] { requestUiUpdate(false /*readyForSync*/); /*throw X*/ },
-                                                                                cbInterval); //throw FileError
-
-                //give precedence to ChangeType::baseFolderUnavailable
-                for (const DirWatcher::Change& change : changes)
-                    if (change.type == DirWatcher::ChangeType::baseFolderUnavailable)
-                        return change;
+                    return {{DirWatcher::ChangeType::baseFolderUnavailable, folderPath}};
 
-                std::erase_if(changes, [](const DirWatcher::Change& e)
-                {
-                    return
-                        endsWith(e.itemPath, Zstr(".ffs_tmp"))  || //sync.8ea2.ffs_tmp
-                        endsWith(e.itemPath, Zstr(".ffs_lock")) || //sync.ffs_lock, sync.Del.ffs_lock
-                        endsWith(e.itemPath, Zstr(".ffs_db"));     //sync.ffs_db
-                    //no need to ignore temporary recycle bin directory: this must be caused by a file deletion anyway
-                });
-
-                if (!changes.empty())
-                    return changes[0];
-            }
-            catch (FileError&)
-            {
-                if (!dirAvailable(folderPath)) //a benign(?) race condition with FileError
-                    return {DirWatcher::ChangeType::baseFolderUnavailable, folderPath};
-                throw;
-            }
+        if (std::vector<DirWatcher::Change> changes = fetchChanges(watches, [&] { requestUiUpdate(false /*readyForSync*/); /*throw X*/ }, cbInterval); //throw FileError
+            !changes.empty())
+        {
+            if (changes[0].type != DirWatcher::ChangeType::baseFolderUnavailable)
+                append(changes, renewWatches(watches, folderPaths, [] {}, cbInterval)); //throw FileError
+            return changes;
         }
 
         std::this_thread::sleep_for(cbInterval);
@@ -200,7 +234,7 @@ struct ExecCommandNowException {};
 
 
 void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std::chrono::seconds delay,
-                             const std::function<void(const Zstring& itemPath, const std::wstring& actionName)>& executeExternalCommand /*throw FileError*/,
+                             const std::function<void(const Zstring& itemPath, const std::wstring& actionName, const fff::ChangeList* changes)>& executeExternalCommand /*throw FileError*/,
                              const std::function<void(const Zstring* missingFolderPath)>& requestUiUpdate,
                              const std::function<void(const std::wstring& msg         )>& reportError,
                              std::chrono::milliseconds cbInterval)
@@ -217,6 +251,21 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
             //schedule initial execution (*after* all directories have arrived)
             auto nextExecTime = std::chrono::steady_clock::now() + delay;
 
+            DirWatches watches;
+            std::optional<std::set<Zstring>> changedItems; //changes since last successful execution; initial execution: unknown
+
+            auto addChanges = [&](const std::vector<DirWatcher::Change>& changes)
+            {
+                for (const DirWatcher::Change& change : changes)
+                    if (change.type == DirWatcher::ChangeType::baseFolderUnavailable)
+                    {
+                        changedItems = std::nullopt; //we don't know what happened in the meantime
+                        watches.clear();
+                    }
+                    else if (changedItems)
+                        changedItems->insert(change.itemPath);
+            };
+
             for (;;) //command executions
             {
                 DirWatcher::Change lastChangeDetected;
@@ -224,13 +273,17 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
                 {
                     for (;;) //detected changes
                     {
-                        lastChangeDetected = waitForChanges(folderPaths, [&](bool readyForSync) //throw FileError, ExecCommandNowException
+                        const std::vector<DirWatcher::Change> changes = waitForChanges(folderPaths, watches, [&](bool readyForSync) //throw FileError, ExecCommandNowException
                         {
                             requestUiUpdate(nullptr);
 
                             if (readyForSync && std::chrono::steady_clock::now() >= nextExecTime)
                                 throw ExecCommandNowException(); //abort wait and start sync
                         }, cbInterval);
+                        assert(!changes.empty());
+
+                        lastChangeDetected = changes[0];
+                        addChanges(changes);
 
                         if (lastChangeDetected.type == DirWatcher::ChangeType::baseFolderUnavailable)
                             //don't execute the command before all directories are available!
@@ -241,11 +294,20 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
                 }
                 catch (ExecCommandNowException&) {}
 
+                std::optional<fff::ChangeList> changeList;
+                if (changedItems)
+                    changeList = fff::ChangeList{{folderPaths.begin(), folderPaths.end()}, *changedItems};
+
                 try
                 {
-                    executeExternalCommand(lastChangeDetected.itemPath, getChangeTypeName(lastChangeDetected.type)); //throw FileError
+                    executeExternalCommand(lastChangeDetected.itemPath, getChangeTypeName(lastChangeDetected.type), changeList ? &*changeList : nullptr); //throw FileError
+
+                    //watches stayed active during execution: changes (including those by the command itself) are needed for next change list, but must not trigger it
+                    changedItems = std::set<Zstring>();
                 }
-                catch (const FileError& e) { reportError(e.toString()); }
+                catch (const FileError& e) { reportError(e.toString()); } //sync may have failed => keep changes
+
+                addChanges(fetchChanges(watches, [&] { requestUiUpdate(nullptr); }, cbInterval)); //throw FileError
 
                 nextExecTime = std::chrono::steady_clock::time_point::max();
             }
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <functional>
 #include <zen/zstring.h>
+#include "../base/change_list.h"
 
 
 namespace rts
@@ -17,7 +18,8 @@ namespace rts
 void monitorDirectories(const std::vector<Zstring>& folderPathPhrases,
                         //non-formatted paths that yet require call to getFormattedDirectoryName(); empty directories must be checked by caller!
                         std::chrono::seconds delay,
-                        const std::function<void(const Zstring& changedItemPath, const std::wstring& actionName)>& executeExternalCommand,
+                        const std::function<void(const Zstring& changedItemPath, const std::wstring& actionName,
+                                                 const fff::ChangeList* changes /*optional: not known completely*/)>& executeExternalCommand,
                         const std::function<void(const Zstring* missingFolderPath)>& requestUiUpdate, //either waiting for change notifications or at least one folder is missing
                         const std::function<void(const std::wstring& msg         )>& reportError, //automatically retries after return!
                         std::chrono::milliseconds cbInterval);
@@ -15,11 +15,15 @@
 #include <wx/timer.h>
 #include <wx+/image_tools.h>
 #include <zen/process_exec.h>
+#include <zen/file_access.h>
+#include <zen/crc.h>
+#include <zen/guid.h>
 #include <wx+/popup_dlg.h>
 #include <wx+/image_resources.h>
 #include "monitor.h"
 
 using namespace zen;
+using namespace fff;
 using namespace rts;
 
 
@@ -249,10 +253,35 @@ rts::AbortReason rts::runFolderMonitor(const XmlRealConfig& config, const wxStri
 
     TrayIconHolder trayIcon(jobname);
 
-    auto executeExternalCommand = [&](const Zstring& changedItemPath, const std::wstring& actionName) //throw FileError
+    //e.g. /tmp/RealTimeSync-068b2e88.ffs_changes
+    Zstring changeListPath;
+    try
+    {
+        changeListPath = appendSeparator(getTempFolderPath()) + Zstr("RealTimeSync-") + //throw FileError
+                         printNumber<Zstring>(Zstr("%08x"), static_cast<unsigned int>(getCrc32(generateGUID()))) + Zstr(".ffs_changes");
+    }
+    catch (FileError&) {} //not critical: fall back to full comparison
+
+    ZEN_ON_SCOPE_EXIT(if (!changeListPath.empty())
+                      try { removeFilePlain(changeListPath); /*throw FileError*/ }
+                      catch (FileError&) {});
+
+    auto executeExternalCommand = [&](const Zstring& changedItemPath, const std::wstring& actionName, const ChangeList* changes) //throw FileError
     {
         ::wxSetEnv(L"change_path", utfTo<wxString>(changedItemPath)); //crude way to report changed file
         ::wxSetEnv(L"change_action", actionName);                     //
+
+        //incremental comparison: FreeFileSync.exe "SyncJob.ffs_batch" -ChangeList "%change_list%"
+        Zstring changeListPathOpt;
+        if (changes && !changeListPath.empty())
+            try
+            {
+                saveChangeList(*changes, changeListPath); //throw FileError
+                changeListPathOpt = changeListPath;
+            }
+            catch (FileError&) {} //not critical: fall back to full comparison
+        ::wxSetEnv(L"change_list", utfTo<wxString>(changeListPathOpt)); //empty if changes are not known completely
+
         auto cmdLineExp = expandMacros(cmdLine);
 
         try
@@ -5,10 +5,12 @@
 // *****************************************************************************
 
 #include "abstract.h"
+#include <future>
 #include <zen/serialize.h>
 #include <zen/guid.h>
 #include <zen/crc.h>
 #include <typeindex>
+#include "abstract_impl.h"
 
 using namespace zen;
 using namespace fff;
@@ -103,6 +105,14 @@ void AFS::traverseFolderFlat(const AfsPath& afsPath, //throw FileError
 
 
 //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
+namespace
+{
+//small files: overlapping reads and writes is not worth the thread creation (~1/20 ms)
+const uint64_t ASYNC_STREAM_COPY_MIN_SIZE    = 1024 * 1024;     //unit: [byte]
+const size_t   ASYNC_STREAM_COPY_BUFFER_SIZE = 4 * 1024 * 1024; //unit: [byte]
+}
+
+
 AFS::FileCopyResult AFS::copyFileAsStream(const AfsPath& afsSource, const StreamAttributes& attrSource, //throw FileError, ErrorFileLocked, X
                                           const AbstractPath& apTarget, const IoCallback& notifyUnbufferedIO /*throw X*/) const
 {
@@ -115,20 +125,100 @@ AFS::FileCopyResult AFS::copyFileAsStream(const AfsPath& afsSource, const Stream
     auto notifyUnbufferedWrite = [&](int64_t bytesDelta) { totalBytesWritten += bytesDelta; cbd(bytesDelta); };
     //--------------------------------------------------------------------------------------------------------
 
-    auto streamIn = getInputStream(afsSource, notifyUnbufferedRead); //throw FileError, ErrorFileLocked
+    auto getCurrentAttributes = [&](InputStream& streamIn) //throw FileError
+    {
+        //try to get the most current attributes if possible (input file might have changed after comparison!)
+        if (std::optional<StreamAttributes> attr = streamIn.getAttributesBuffered()) //throw FileError
+            return *attr; //Native/MTP/Google Drive
+        else //use possibly stale ones:
+            return attrSource; //SFTP/FTP
+        //TODO: evaluate: consequences of stale attributes
+    };
 
     StreamAttributes attrSourceNew = {};
-    //try to get the most current attributes if possible (input file might have changed after comparison!)
-    if (std::optional<StreamAttributes> attr = streamIn->getAttributesBuffered()) //throw FileError
-        attrSourceNew = *attr; //Native/MTP/Google Drive
-    else //use possibly stale ones:
-        attrSourceNew = attrSource; //SFTP/FTP
-    //TODO: evaluate: consequences of stale attributes
+    std::unique_ptr<OutputStream> streamOut;
+
+    if (attrSource.fileSize < ASYNC_STREAM_COPY_MIN_SIZE)
+    {
+        auto streamIn = getInputStream(afsSource, notifyUnbufferedRead); //throw FileError, ErrorFileLocked
+
+        attrSourceNew = getCurrentAttributes(*streamIn); //throw FileError
+
+        //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
+        streamOut = getOutputStream(apTarget, attrSourceNew.fileSize, attrSourceNew.modTime, notifyUnbufferedWrite); //throw FileError
+
+        bufferedStreamCopy(*streamIn, *streamOut); //throw FileError, ErrorFileLocked, X
+    }
+    else
+    {
+        /*  overlap reads and writes: throughput max(R, W) instead of 1/(1/R + 1/W)
+            - reader thread fills a bounded buffer while this thread writes
+            - input stream is created, used and destroyed on the reader thread only: SFTP sessions are bound to their thread!
+            - reader thread only counts unbuffered reads: report them (throw X) from this thread            */
+        AsyncStreamBuffer asyncStreamBuf(ASYNC_STREAM_COPY_BUFFER_SIZE);
+        std::atomic<int64_t> bytesReadAsync{0}; //std:atomic is uninitialized by default!
+
+        std::promise<std::pair<StreamAttributes, size_t /*blockSize*/>> pStreamInfo;
+        auto futStreamInfo = pStreamInfo.get_future();
+
+        InterruptibleThread reader([&, pStreamInfo = std::move(pStreamInfo)]() mutable
+        {
+            setCurrentThreadName(Zstr("Istream ") + utfTo<Zstring>(getDisplayPath(afsSource)));
+            bool streamInfoSet = false;
+            try
+            {
+                auto streamIn = getInputStream(afsSource, [&](int64_t bytesDelta) { bytesReadAsync += bytesDelta; }); //throw FileError, ErrorFileLocked
+
+                const size_t blockSize = streamIn->getBlockSize();
+                assert(blockSize > 0); //non-zero block size is AFS contract!
+
+                pStreamInfo.set_value({getCurrentAttributes(*streamIn), blockSize}); //throw FileError
+                streamInfoSet = true;
+
+                std::vector<std::byte> buffer(blockSize);
+                for (;;)
+                {
+                    const size_t bytesRead = streamIn->read(&buffer[0], blockSize); //throw FileError, ErrorFileLocked; return "bytesToRead" bytes unless end of stream!
+                    asyncStreamBuf.write(&buffer[0], bytesRead); //throw ThreadStopRequest
+
+                    if (bytesRead < blockSize) //end of file
+                        break;
+                }
+                asyncStreamBuf.closeStream();
+            }
+            catch (FileError&) //let ThreadStopRequest pass through!
+            {
+                if (streamInfoSet)
+                    asyncStreamBuf.setWriteError(std::current_exception());
+                else
+                    pStreamInfo.set_exception(std::current_exception());
+            }
+        });
+        //reader thread might be blocked on full buffer: unblock before ~InterruptibleThread() joins
+        ZEN_ON_SCOPE_FAIL(asyncStreamBuf.setReadError(std::make_exception_ptr(ThreadStopRequest())));
+
+        auto reportBytesRead = [&] { notifyUnbufferedRead(bytesReadAsync - totalBytesRead); }; //throw X
 
-    //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
-    auto streamOut = getOutputStream(apTarget, attrSourceNew.fileSize, attrSourceNew.modTime, notifyUnbufferedWrite); //throw FileError
+        const auto [attrSourceCurrent, blockSize] = futStreamInfo.get(); //throw FileError, ErrorFileLocked
+        attrSourceNew = attrSourceCurrent;
+        reportBytesRead(); //throw X
 
-    bufferedStreamCopy(*streamIn, *streamOut); //throw FileError, ErrorFileLocked, X
+        //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
+        streamOut = getOutputStream(apTarget, attrSourceNew.fileSize, attrSourceNew.modTime, notifyUnbufferedWrite); //throw FileError
+
+        std::vector<std::byte> buffer(blockSize);
+        for (;;)
+        {
+            const size_t bytesRead = asyncStreamBuf.read(&buffer[0], blockSize); //throw FileError, ErrorFileLocked
+            reportBytesRead(); //throw X
+
+            streamOut->write(&buffer[0], bytesRead); //throw FileError, X
+
+            if (bytesRead < blockSize) //end of file
+                break;
+        }
+        //no need for checkWriteErrors(): once end of stream is reached, closeStream() was called => no errors occured
+    }
 
     //check incomplete input *before* failing with (slightly) misleading error message in OutputStream::finalize()
     if (totalBytesRead != makeSigned(attrSourceNew.fileSize))
@@ -207,6 +207,14 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
         bool isFollowedSymlink;
     };
 
+    struct FolderFingerprint //changes when items are added, removed or renamed (but NOT when a file is modified in place!)
+    {
+        int64_t modTimeNs; //nanoseconds since Jan. 1st 1970 UTC
+        FingerPrint folderPrint;
+
+        bool operator==(const FolderFingerprint&) const = default;
+    };
+
     struct TraverserCallback
     {
         virtual ~TraverserCallback() {}
@@ -237,11 +245,27 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
 
         virtual HandleError reportDirError (const ErrorInfo& errorInfo)                          = 0; //failed directory traversal -> consider directory data at current level as incomplete!
         virtual HandleError reportItemError(const ErrorInfo& errorInfo, const Zstring& itemName) = 0; //failed to get data for single file/dir/symlink only!
+
+        //optional: name-only pre-check before reading item attributes (saves one stat() per excluded item); used by traversers that list names first (native only)
+        //itemType: if known without extra I/O, e.g. d_type; false: skip item silently => no onFile()/onSymlink()/onFolder(), no error reporting
+        virtual bool mayReportItem(const Zstring& itemName, std::optional<ItemType> itemType) { return true; }
+
+        //optional: folder content cache; used by traversers that can fingerprint folders (native only)
+        struct FolderListing //unfiltered, excluding followed symlinks
+        {
+            std::vector<FileInfo>    files;
+            std::vector<FolderInfo>  folders;
+            std::vector<SymlinkInfo> symlinks;
+        };
+        virtual bool cachesFolderContent() const { return false; }
+        //called after opening the folder, before reading it: return previous content to skip reading => items are reported via onFile()/onFolder()/onSymlink() as usual
+        virtual const FolderListing* onFolderOpened(const FolderFingerprint& fp) { return nullptr; } //throw X
     };
 
     using TraverserWorkload = std::vector<std::pair<AfsPath, std::shared_ptr<TraverserCallback> /*throw X*/>>;
 
     //- client needs to handle duplicate file reports! (FilePlusTraverser fallback, retrying to read directory contents, ...)
+    //- parallelOps > 1: TraverserCallback calls may come from different threads, but are always serialized
     static void traverseFolderRecursive(const AfsDevice& afsDevice, const TraverserWorkload& workload /*throw X*/, size_t parallelOps) { afsDevice.ref().traverseFolderRecursive(workload, parallelOps); }
 
     static void traverseFolderFlat(const AbstractPath& ap, //throw FileError
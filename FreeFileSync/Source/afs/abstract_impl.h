@@ -58,6 +58,175 @@ bool tryReportingItemError(Command cmd, AbstractFileSystem::TraverserCallback& c
 }
 //==========================================================================================
 
+/* ___________________________________
+   |                                 |
+   | Multithreaded Folder Traversal  |
+   |_________________________________|
+
+   - similar design as "Multithreaded File Copy" in synchronization.cpp
+   - all threads share a single mutex, unlocked only during file I/O => TraverserCallback invocations are serialized (even across workload items)
+   - each worker thread owns a LIFO bucket of folders: depth-first traversal => limit memory consumption
+   - idle worker steals half of the largest bucket: oldest items first => folders closest to root => biggest subtrees
+   - calling thread participates as worker #0 => must be an InterruptibleThread (uses interruptibleWait())                  */
+template <class NativePath>
+class ParallelFolderTraverser
+{
+public:
+    using Workload = std::vector<std::pair<NativePath, std::shared_ptr<AbstractFileSystem::TraverserCallback>>>;
+
+    explicit ParallelFolderTraverser(size_t parallelOps) : buckets_(parallelOps)
+    { if (parallelOps == 0) throw std::logic_error("Contract violation! " + std::string(__FILE__) + ':' + zen::numberTo<std::string>(__LINE__)); }
+
+    //traverseFolder: void(const NativePath& folderPath, TraverserCallback& cb, size_t threadIdx) throw FileError, X
+    //  => runs with mutex locked: call file I/O via parallelScope() and report sub folders via addFolder()
+    template <class Function>
+    void run(const Workload& workload /*throw X*/, Function traverseFolder) //throw X
+    {
+        assert(itemsPending_ == 0 && workersActive_ == 0);
+
+        for (const auto& [folderPath, cb] : workload)
+            buckets_[itemsPending_++ % buckets_.size()].push_back(WorkItem{folderPath, cb});
+
+        std::vector<zen::InterruptibleThread> worker;
+        ZEN_ON_SCOPE_EXIT( for (zen::InterruptibleThread& wt : worker) wt.requestStop(); ); //stop *all* at the same time before join!
+
+        for (size_t threadIdx = 1; threadIdx < buckets_.size(); ++threadIdx)
+        {
+            Zstring threadName = Zstr("Traverser[") + zen::numberTo<Zstring>(threadIdx + 1) + Zstr('/') + zen::numberTo<Zstring>(buckets_.size()) + Zstr(']');
+
+            ++workersActive_;
+            worker.emplace_back([this, threadIdx, traverseFolder, threadName = std::move(threadName)]
+            {
+                zen::setCurrentThreadName(threadName);
+                ZEN_ON_SCOPE_EXIT(notifyWorkerDone());
+                try
+                {
+                    runWorker(threadIdx, traverseFolder); //throw X
+                }
+                catch (zen::ThreadStopRequest&) { throw; }
+                catch (...) //pass error to worker #0
+                {
+                    std::lock_guard dummy(lockWork_);
+                    if (!workerError_)
+                        workerError_ = std::current_exception();
+                    conditionNewWork_.notify_all();
+                }
+            });
+        }
+
+        runWorker(0, traverseFolder); //throw X
+
+        std::unique_lock dummy(lockWork_);
+        zen::interruptibleWait(conditionNewWork_, dummy, [this] { return workersActive_ == 0; }); //throw ThreadStopRequest
+
+        if (workerError_)
+            std::rethrow_exception(workerError_); //throw X
+    }
+
+    //context of traverseFolder(): mutex is locked
+    void addFolder(size_t threadIdx, const NativePath& folderPath, std::shared_ptr<AbstractFileSystem::TraverserCallback>&& cb)
+    {
+        buckets_[threadIdx].push_back(WorkItem{folderPath, std::move(cb)});
+        ++itemsPending_;
+        conditionNewWork_.notify_all();
+    }
+
+    //context of traverseFolder(): run file I/O without holding the mutex
+    template <class Function>
+    auto parallelScope(Function&& fun) //throw X
+    {
+        lockWork_.unlock();
+        ZEN_ON_SCOPE_EXIT(lockWork_.lock());
+
+        return fun(); //throw X
+    }
+
+private:
+    ParallelFolderTraverser           (const ParallelFolderTraverser&) = delete;
+    ParallelFolderTraverser& operator=(const ParallelFolderTraverser&) = delete;
+
+    struct WorkItem
+    {
+        NativePath folderPath;
+        std::shared_ptr<AbstractFileSystem::TraverserCallback> cb;
+    };
+    using WorkItems = zen::RingBuffer<WorkItem>;
+
+    template <class Function>
+    void runWorker(size_t threadIdx, const Function& traverseFolder) //throw X
+    {
+        std::unique_lock dummy(lockWork_);
+        while (std::optional<WorkItem> wi = getNext(threadIdx, dummy)) //throw ThreadStopRequest
+        {
+            tryReportingDirError([&] //throw X
+            {
+                traverseFolder(wi->folderPath, *wi->cb, threadIdx); //throw FileError, X
+            }, *wi->cb);
+
+            assert(itemsPending_ > 0);
+            if (--itemsPending_ == 0)
+                conditionNewWork_.notify_all();
+        }
+    }
+
+    void notifyWorkerDone()
+    {
+        {
+            std::lock_guard dummy(lockWork_);
+            assert(workersActive_ > 0);
+            --workersActive_;
+        }
+        conditionNewWork_.notify_all();
+    }
+
+    //blocking call: return std::nullopt when all work is done (or another worker failed)
+    std::optional<WorkItem> getNext(size_t threadIdx, std::unique_lock<std::mutex>& dummy) //throw ThreadStopRequest
+    {
+        for (;;)
+        {
+            if (workerError_)
+                return std::nullopt;
+
+            if (WorkItems& items = buckets_[threadIdx];
+                !items.empty())
+            {
+                WorkItem wi = std::move(items.    back()); //LIFO: depth-first
+                /**/                    items.pop_back();
+                return wi;
+            }
+
+            WorkItems& items = *std::max_element(buckets_.begin(), buckets_.end(), [](const WorkItems& lhs, const WorkItems& rhs) { return lhs.size() < rhs.size(); });
+            if (!items.empty()) //=> != buckets_[threadIdx]
+            {
+                //steal half of largest workload from other thread: oldest items first
+                const size_t stealCount = (items.size() + 1) / 2;
+                for (size_t i = 0; i < stealCount; ++i)
+                {
+                    buckets_[threadIdx].push_back(std::move(items.front()));
+                    items.pop_front();
+                }
+            }
+            else if (itemsPending_ == 0) //all buckets empty and no worker busy => done!
+                return std::nullopt;
+            else //wait...
+                zen::interruptibleWait(conditionNewWork_, dummy, [this] //throw ThreadStopRequest
+            {
+                return itemsPending_ == 0 || workerError_ || std::any_of(buckets_.begin(), buckets_.end(), [](const WorkItems& wi) { return !wi.empty(); });
+            });
+        }
+    }
+
+    std::mutex lockWork_;
+    std::condition_variable conditionNewWork_;
+
+    std::vector<WorkItems> buckets_; //thread-specific buckets
+    size_t itemsPending_ = 0; //queued + currently traversed folders
+    size_t workersActive_ = 0; //excluding worker #0
+    std::exception_ptr workerError_;
+};
+
+//==========================================================================================
+
 /*   implement streaming API on top of libcurl's icky callback-based design
         => support copying arbitrarily-large files: https://freefilesync.org/forum/viewtopic.php?t=4471
         => maximum performance through async processing (prefetching + output buffer!)
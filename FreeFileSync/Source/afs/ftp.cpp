@@ -1527,6 +1527,56 @@ private:
 };
 
 
+//ioScope: run FTP requests, e.g. outside of a lock; addFolder: schedule traversal of sub folder
+template <class IoScope, class AddFolder>
+void traverseFolderWithException(const FtpLogin& login, const AfsPath& dirPath, AFS::TraverserCallback& cb, IoScope ioScope, AddFolder addFolder) //throw FileError, X
+{
+    for (const FtpItem& item : ioScope([&] { return FtpDirectoryReader::execute(login, dirPath); })) //throw FileError
+    {
+        const AfsPath itemPath(nativeAppendPaths(dirPath.value, item.itemName));
+
+        switch (item.type)
+        {
+            case AFS::ItemType::file:
+                cb.onFile({item.itemName, item.fileSize, item.modTime, item.filePrint, false /*isFollowedSymlink*/}); //throw X
+                break;
+
+            case AFS::ItemType::folder:
+                if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({item.itemName, false /*isFollowedSymlink*/})) //throw X
+                    addFolder(itemPath, std::move(cbSub));
+                break;
+
+            case AFS::ItemType::symlink:
+                switch (cb.onSymlink({item.itemName, item.modTime})) //throw X
+                {
+                    case AFS::TraverserCallback::HandleLink::follow:
+                    {
+                        FtpItem target = {};
+                        if (!tryReportingItemError([&] //throw X
+                    {
+                        target = ioScope([&] { return getFtpSymlinkInfo(login, itemPath); }); //throw FileError
+                        }, cb, item.itemName))
+                        continue;
+
+                        if (target.type == AFS::ItemType::folder)
+                        {
+                            if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({item.itemName, true /*isFollowedSymlink*/})) //throw X
+                                addFolder(itemPath, std::move(cbSub));
+                        }
+                        else //a file or named pipe, etc.
+                            cb.onFile({item.itemName, target.fileSize, target.modTime, item.filePrint, true /*isFollowedSymlink*/}); //throw X
+                    }
+                    break;
+
+                    case AFS::TraverserCallback::HandleLink::skip:
+                        break;
+                }
+                break;
+        }
+    }
+}
+
+
 class SingleFolderTraverser
 {
 public:
@@ -1541,7 +1591,8 @@ public:
 
             tryReportingDirError([&] //throw X
             {
-                traverseWithException(folderPath, *cb); //throw FileError, X
+                traverseFolderWithException(login_, folderPath, *cb, [](auto&& fun) { return fun(); }, //throw FileError, X
+                [&](const AfsPath& itemPath, std::shared_ptr<AFS::TraverserCallback>&& cbSub) { workload_.push_back({itemPath, std::move(cbSub)}); });
             }, *cb);
         }
     }
@@ -1550,61 +1601,26 @@ private:
     SingleFolderTraverser           (const SingleFolderTraverser&) = delete;
     SingleFolderTraverser& operator=(const SingleFolderTraverser&) = delete;
 
-    void traverseWithException(const AfsPath& dirPath, AFS::TraverserCallback& cb) //throw FileError, X
-    {
-        for (const FtpItem& item : FtpDirectoryReader::execute(login_, dirPath)) //throw FileError
-        {
-            const AfsPath itemPath(nativeAppendPaths(dirPath.value, item.itemName));
-
-            switch (item.type)
-            {
-                case AFS::ItemType::file:
-                    cb.onFile({item.itemName, item.fileSize, item.modTime, item.filePrint, false /*isFollowedSymlink*/}); //throw X
-                    break;
-
-                case AFS::ItemType::folder:
-                    if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({item.itemName, false /*isFollowedSymlink*/})) //throw X
-                        workload_.push_back({itemPath, std::move(cbSub)});
-                    break;
-
-                case AFS::ItemType::symlink:
-                    switch (cb.onSymlink({item.itemName, item.modTime})) //throw X
-                    {
-                        case AFS::TraverserCallback::HandleLink::follow:
-                        {
-                            FtpItem target = {};
-                            if (!tryReportingItemError([&] //throw X
-                        {
-                            target = getFtpSymlinkInfo(login_, itemPath); //throw FileError
-                            }, cb, item.itemName))
-                            continue;
-
-                            if (target.type == AFS::ItemType::folder)
-                            {
-                                if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({item.itemName, true /*isFollowedSymlink*/})) //throw X
-                                    workload_.push_back({itemPath, std::move(cbSub)});
-                            }
-                            else //a file or named pipe, etc.
-                                cb.onFile({item.itemName, target.fileSize, target.modTime, item.filePrint, true /*isFollowedSymlink*/}); //throw X
-                        }
-                        break;
-
-                        case AFS::TraverserCallback::HandleLink::skip:
-                            break;
-                    }
-                    break;
-            }
-        }
-    }
-
     std::vector<std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>> workload_;
     const FtpLogin login_;
 };
 
 
-void traverseFolderRecursiveFTP(const FtpLogin& login, const std::vector<std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/, size_t) //throw X
+void traverseFolderRecursiveFTP(const FtpLogin& login, const std::vector<std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/, size_t parallelOps) //throw X
 {
-    SingleFolderTraverser dummy(login, workload); //throw X
+    if (parallelOps <= 1)
+    {
+        SingleFolderTraverser dummy(login, workload); //throw X
+        return;
+    }
+
+    //FTP listing is latency-bound: each worker thread gets its own FtpSession from FtpSessionManager (session count bounded by parallelOps)
+    ParallelFolderTraverser<AfsPath> pft(parallelOps);
+    pft.run(workload, [&pft, &login](const AfsPath& dirPath, AFS::TraverserCallback& cb, size_t threadIdx) //throw X
+    {
+        traverseFolderWithException(login, dirPath, cb, [&](auto&& fun) { return pft.parallelScope(fun); }, //throw FileError, X
+        [&](const AfsPath& itemPath, std::shared_ptr<AFS::TraverserCallback>&& cbSub) { pft.addFolder(threadIdx, itemPath, std::move(cbSub)); });
+    });
 }
 //===========================================================================================================================
 //===========================================================================================================================
@@ -14,10 +14,12 @@
 #include <zen/thread.h>
 #include <zen/guid.h>
 #include <zen/crc.h>
+#include <zen/batch_stat.h>
 #include "abstract_impl.h"
 #include "../base/icon_loader.h"
 
     #include <sys/vfs.h> //statfs
+    #include <linux/magic.h> //NFS_SUPER_MAGIC, SMB_SUPER_MAGIC
 
     #include <sys/stat.h>
     #include <dirent.h>
@@ -98,119 +100,388 @@ NativeFileInfo getFileAttributes(FileBase::FileHandle fh) //throw SysError
 struct FsItem
 {
     Zstring itemName;
+    std::optional<ItemType> type; //from dirent::d_type, if reported by file system
 };
-std::vector<FsItem> getDirContentFlat(const Zstring& dirPath) //throw FileError
+
+
+struct FsItemDetails
+{
+    ItemType type;
+    time_t   modTime; //number of seconds since Jan. 1st 1970 UTC
+    uint64_t fileSize; //unit: bytes!
+    AFS::FingerPrint filePrint;
+};
+
+
+/* keep folder handle open while traversing: get item attributes relative to it (fstatat/statx)
+    => no path concatenation per item + kernel doesn't need to re-walk the full path for each item (deep hierarchies!)  */
+class FolderReader
 {
-    //no need to check for endless recursion:
-    //1. Linux has a fixed limit on the number of symbolic links in a path
-    //2. fails with "too many open files" or "path too long" before reaching stack overflow
-
-    DIR* folder = ::opendir(dirPath.c_str()); //directory must NOT end with path separator, except "/"
-    if (!folder)
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(dirPath)), "opendir");
-    ZEN_ON_SCOPE_EXIT(::closedir(folder)); //never close nullptr handles! -> crash
-
-    std::vector<FsItem> output;
-    for (;;)
-    {
-        /* Linux: https://man7.org/linux/man-pages/man3/readdir_r.3.html
-                "It is recommended that applications use readdir(3) instead of readdir_r"
-                "... in modern implementations (including the glibc implementation), concurrent calls to readdir(3) that specify different directory streams are thread-safe"
-
-           macOS: - libc: readdir thread-safe already in code from 2000: https://opensource.apple.com/source/Libc/Libc-166/gen.subproj/readdir.c.auto.html
-                  - and in the latest version from 2017:                 https://opensource.apple.com/source/Libc/Libc-1244.30.3/gen/FreeBSD/readdir.c.auto.html                   */
-        errno = 0;
-        const dirent* dirEntry = ::readdir(folder);
-        if (!dirEntry)
+public:
+    explicit FolderReader(const Zstring& dirPath) : //throw FileError
+        dirPath_(dirPath),
+        folder_(::opendir(dirPath.c_str())) //directory must NOT end with path separator, except "/"
+    {
+        //no need to check for endless recursion:
+        //1. Linux has a fixed limit on the number of symbolic links in a path
+        //2. fails with "too many open files" or "path too long" before reaching stack overflow
+        if (!folder_)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(dirPath)), "opendir");
+    }
+
+    ~FolderReader() { ::closedir(folder_); } //never close nullptr handles! -> crash
+
+    std::vector<FsItem> getContentFlat() //throw FileError
+    {
+        std::vector<FsItem> output;
+        for (;;)
         {
-            if (errno == 0) //errno left unchanged => no more items
-                return output;
+            /* Linux: https://man7.org/linux/man-pages/man3/readdir_r.3.html
+                    "It is recommended that applications use readdir(3) instead of readdir_r"
+                    "... in modern implementations (including the glibc implementation), concurrent calls to readdir(3) that specify different directory streams are thread-safe"
+
+               macOS: - libc: readdir thread-safe already in code from 2000: https://opensource.apple.com/source/Libc/Libc-166/gen.subproj/readdir.c.auto.html
+                      - and in the latest version from 2017:                 https://opensource.apple.com/source/Libc/Libc-1244.30.3/gen/FreeBSD/readdir.c.auto.html                   */
+            errno = 0;
+            const dirent* dirEntry = ::readdir(folder_);
+            if (!dirEntry)
+            {
+                if (errno == 0) //errno left unchanged => no more items
+                    return output;
+
+                THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath_)), "readdir");
+                //don't retry but restart dir traversal on error! https://devblogs.microsoft.com/oldnewthing/20140612-00/?p=753
+            }
 
-            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), "readdir");
-            //don't retry but restart dir traversal on error! https://devblogs.microsoft.com/oldnewthing/20140612-00/?p=753
+            const char* itemNameRaw = dirEntry->d_name;
+
+            //skip "." and ".."
+            if (itemNameRaw[0] == '.' &&
+                (itemNameRaw[1] == 0 || (itemNameRaw[1] == '.' && itemNameRaw[2] == 0)))
+                continue;
+
+            if (itemNameRaw[0] == 0) //show error instead of endless recursion!!!
+                throw FileError(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath_)), formatSystemError("readdir", L"", L"Folder contains an item without name."));
+
+            //DT_UNKNOWN: file system doesn't support d_type (e.g. some XFS, ReiserFS, NFS setups) => lstat needed
+            std::optional<ItemType> itemType;
+            switch (dirEntry->d_type)
+            {
+                case DT_DIR: itemType = ItemType::folder;  break;
+                case DT_LNK: itemType = ItemType::symlink; break;
+                case DT_UNKNOWN:                           break;
+                default:     itemType = ItemType::file;    break; //a file or named pipe, etc.
+            }
+
+            output.push_back({itemNameRaw, itemType});
+
+            /* Unicode normalization is file-system-dependent:
+
+                   OS                 Accepts   Gives back
+                   ----------         -------   ----------
+                   macOS (HFS+)         all        NFD
+                   Linux                all      <input>
+                   Windows (NTFS, FAT)  all      <input>
+
+                some file systems return precomposed others decomposed UTF8: https://developer.apple.com/library/archive/qa/qa1173/_index.html
+                      - OS X edit controls and text fields may return precomposed UTF as directly received by keyboard or decomposed UTF that was copy & pasted!
+                      - Posix APIs require decomposed form: https://freefilesync.org/forum/viewtopic.php?t=2480
+
+                => General recommendation: always preserve input UNCHANGED (both unicode normalization and case sensitivity)
+                => normalize only when needed during string comparison
+
+                Create sample files on Linux: touch  decomposed-$'\x6f\xcc\x81'.txt
+                                              touch precomposed-$'\xc3\xb3'.txt
+
+                - list file name hex chars in terminal:  ls | od -c -t x1
+
+                - SMB sharing case-sensitive or NFD file names is fundamentally broken on macOS:
+                    => the macOS SMB manager internally buffers file names as case-insensitive and NFC (= just like NTFS on Windows)
+                    => test: create SMB share from Linux => *boom* on macOS: "Error Code 2: No such file or directory [lstat]"
+                        or WORSE: folders "test" and "Test" *both* incorrectly return the content of one of the two
+                    => Update 2020-04-24: converting to NFC doesn't help: both NFD/NFC forms fail(ENOENT) lstat in FFS, AS WELL AS IN FINDER => macOS bug!         */
         }
+    }
 
-        const char* itemNameRaw = dirEntry->d_name;
+    FsItemDetails getItemDetails(const Zstring& itemName) //throw FileError
+    {
+#ifdef STATX_BASIC_STATS
+        if (!statxUnsupported_)
+        {
+            struct statx itemInfo = {};
+            if (::statx(::dirfd(folder_), itemName.c_str(), statxFlags, statxMask, &itemInfo) == 0)
+            {
+                if (hasRequestedFields(itemInfo))
+                    return getItemDetails(itemInfo);
+                //else: fall back to fstatat() for this item
+            }
+            else
+            {
+                if (errno != ENOSYS) //kernel < 4.11, or blocked by seccomp filter => fall back to fstatat()
+                    THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(appendSeparator(dirPath_) + itemName)), "statx");
+                statxUnsupported_ = true;
+            }
+        }
+#endif
+        struct stat itemInfo = {};
+        if (::fstatat(::dirfd(folder_), itemName.c_str(), &itemInfo, AT_SYMLINK_NOFOLLOW) != 0) //does not resolve symlinks
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(appendSeparator(dirPath_) + itemName)), "fstatat");
 
-        //skip "." and ".."
-        if (itemNameRaw[0] == '.' &&
-            (itemNameRaw[1] == 0 || (itemNameRaw[1] == '.' && itemNameRaw[2] == 0)))
-            continue;
+        return {S_ISLNK(itemInfo.st_mode) ? ItemType::symlink : //on Linux there is no distinction between file and directory symlinks!
+                /**/ (S_ISDIR(itemInfo.st_mode) ? ItemType::folder : ItemType::file), //a file or named pipe, etc. => dont't check using S_ISREG(): see comment in file_traverser.cpp
+                itemInfo.st_mtime,
+                makeUnsigned(itemInfo.st_size),
+                getFileFingerprint(itemInfo.st_ino)};
+    }
 
-        if (itemNameRaw[0] == 0) //show error instead of endless recursion!!!
-            throw FileError(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), formatSystemError("readdir", L"", L"Folder contains an item without name."));
+    /* get attributes for all items of the listing that need them at once: io_uring + IORING_OP_STATX
+        => network file systems: overlap the server round trips instead of one blocking stat per item
+        => local file systems: NOT worth it! IORING_OP_STATX is always punted to io-wq worker threads:
+           100.000 files, hot cache: statx() 145 ms vs io_uring 305 ms  => only used for network file systems
 
-        output.push_back({itemNameRaw});
+        returns one entry per item; empty if not applicable; nullopt on error => caller falls back to getItemDetails() for proper error reporting */
+    std::vector<std::optional<FsItemDetails>> getItemDetailsBatch(const std::vector<FsItem>& items) //noexcept
+    {
+#ifdef STATX_BASIC_STATS
+        std::vector<const char*> itemNames;
+        for (const auto& [itemName, itemType] : items)
+            if (itemType != ItemType::folder) //d_type short-circuit: no need for attributes
+                itemNames.push_back(itemName.c_str());
 
-        /* Unicode normalization is file-system-dependent:
+        if (itemNames.size() < 2 || statxUnsupported_ || !isNetworkFileSystem())
+            return {};
 
-               OS                 Accepts   Gives back
-               ----------         -------   ----------
-               macOS (HFS+)         all        NFD
-               Linux                all      <input>
-               Windows (NTFS, FAT)  all      <input>
+        BatchStatx* batchStatx = getBatchStatx();
+        if (!batchStatx)
+            return {};
 
-            some file systems return precomposed others decomposed UTF8: https://developer.apple.com/library/archive/qa/qa1173/_index.html
-                  - OS X edit controls and text fields may return precomposed UTF as directly received by keyboard or decomposed UTF that was copy & pasted!
-                  - Posix APIs require decomposed form: https://freefilesync.org/forum/viewtopic.php?t=2480
+        std::vector<BatchStatx::Result> results;
+        try
+        {
+            results = batchStatx->getItemDetails(::dirfd(folder_), itemNames, statxFlags, statxMask); //throw SysError
+        }
+        catch (SysError&) { return {}; } //no problem: fall back to plain statx()
 
-            => General recommendation: always preserve input UNCHANGED (both unicode normalization and case sensitivity)
-            => normalize only when needed during string comparison
+        std::vector<std::optional<FsItemDetails>> output(items.size());
+        auto itResult = results.begin();
+        for (size_t i = 0; i < items.size(); ++i)
+            if (items[i].type != ItemType::folder)
+            {
+                if (itResult->errorCode == 0 && hasRequestedFields(itResult->itemInfo))
+                    output[i] = getItemDetails(itResult->itemInfo);
+                ++itResult;
+            }
+        return output;
+#else
+        return {};
+#endif
+    }
 
-            Create sample files on Linux: touch  decomposed-$'\x6f\xcc\x81'.txt
-                                          touch precomposed-$'\xc3\xb3'.txt
+    AFS::FolderFingerprint getFingerprint() //throw FileError
+    {
+        struct stat folderInfo = {};
+        if (::fstat(::dirfd(folder_), &folderInfo) != 0)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(dirPath_)), "fstat");
+
+        return {static_cast<int64_t>(folderInfo.st_mtim.tv_sec) * 1'000'000'000 + folderInfo.st_mtim.tv_nsec,
+                getFileFingerprint(folderInfo.st_ino)};
+    }
+
+    FsItemDetails getSymlinkTargetDetails(const Zstring& linkName) //throw FileError
+    {
+        try
+        {
+            struct stat itemInfo = {};
+            if (::fstatat(::dirfd(folder_), linkName.c_str(), &itemInfo, 0 /*flags: follow symlinks*/) != 0)
+                THROW_LAST_SYS_ERROR("fstatat");
 
-            - list file name hex chars in terminal:  ls | od -c -t x1
+            const ItemType targetType = S_ISDIR(itemInfo.st_mode) ? ItemType::folder : ItemType::file;
 
-            - SMB sharing case-sensitive or NFD file names is fundamentally broken on macOS:
-                => the macOS SMB manager internally buffers file names as case-insensitive and NFC (= just like NTFS on Windows)
-                => test: create SMB share from Linux => *boom* on macOS: "Error Code 2: No such file or directory [lstat]"
-                    or WORSE: folders "test" and "Test" *both* incorrectly return the content of one of the two
-                => Update 2020-04-24: converting to NFC doesn't help: both NFD/NFC forms fail(ENOENT) lstat in FFS, AS WELL AS IN FINDER => macOS bug!         */
+            const AFS::FingerPrint filePrint = targetType == ItemType::folder ? 0 : getFileFingerprint(itemInfo.st_ino);
+            return {targetType,
+                    itemInfo.st_mtime,
+                    makeUnsigned(itemInfo.st_size),
+                    filePrint};
+        }
+        catch (const SysError& e)
+        {
+            throw FileError(replaceCpy(_("Cannot resolve symbolic link %x."), L"%x", fmtPath(appendSeparator(dirPath_) + linkName)), e.toString());
+        }
     }
-}
 
+private:
+    FolderReader           (const FolderReader&) = delete;
+    FolderReader& operator=(const FolderReader&) = delete;
 
-struct FsItemDetails
-{
-    ItemType type;
-    time_t   modTime; //number of seconds since Jan. 1st 1970 UTC
-    uint64_t fileSize; //unit: bytes!
-    AFS::FingerPrint filePrint;
+#ifdef STATX_BASIC_STATS
+    //only ask for what we need: NFS/CIFS may skip fetching (or even synchronizing) other attributes
+    static constexpr int statxFlags = AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT; //does not resolve symlinks
+    static constexpr unsigned int statxMask = STATX_TYPE | STATX_MTIME | STATX_SIZE | STATX_INO;
+
+    //network file systems, FUSE: requested fields may be missing => don't mistake zero size/mod time for real values
+    static bool hasRequestedFields(const struct statx& itemInfo) { return (itemInfo.stx_mask & statxMask) == statxMask; }
+
+    static FsItemDetails getItemDetails(const struct statx& itemInfo)
+    {
+        assert(hasRequestedFields(itemInfo));
+        return {S_ISLNK(itemInfo.stx_mode) ? ItemType::symlink : //on Linux there is no distinction between file and directory symlinks!
+                /**/ (S_ISDIR(itemInfo.stx_mode) ? ItemType::folder : ItemType::file), //a file or named pipe, etc. => dont't check using S_ISREG(): see comment in file_traverser.cpp
+                itemInfo.stx_mtime.tv_sec,
+                itemInfo.stx_size,
+                getFileFingerprint(itemInfo.stx_ino)};
+    }
+
+    bool isNetworkFileSystem() const
+    {
+        struct statfs volInfo = {};
+        if (::fstatfs(::dirfd(folder_), &volInfo) != 0)
+            return false;
+
+        switch (volInfo.f_type)
+        {
+            case NFS_SUPER_MAGIC:
+            case SMB_SUPER_MAGIC:
+            case 0xFF534D42: //CIFS_SUPER_MAGIC
+            case 0xFE534D42: //SMB2_SUPER_MAGIC
+            case 0x65735546: //FUSE_SUPER_MAGIC (e.g. sshfs)
+                return true;
+        }
+        return false;
+    }
+
+    static BatchStatx* getBatchStatx() //nullptr if io_uring is not available
+    {
+        if (batchStatxUnsupported_)
+            return nullptr;
+
+        thread_local std::unique_ptr<BatchStatx> batchStatx; //not thread-safe => one per traverser thread
+        if (!batchStatx)
+            try
+            {
+                batchStatx = std::make_unique<BatchStatx>(256 /*queueDepth*/); //throw SysError
+            }
+            catch (SysError&) { batchStatxUnsupported_ = true; return nullptr; } //kernel < 5.6, io_uring disabled
+
+        return batchStatx.get();
+    }
+#endif
+
+    const Zstring dirPath_;
+    DIR* const folder_;
+
+    static inline std::atomic<bool> statxUnsupported_{false}; //std:atomic is uninitialized by default!
+    static inline std::atomic<bool> batchStatxUnsupported_{false}; //
 };
-FsItemDetails getItemDetails(const Zstring& itemPath) //throw FileError
-{
-    struct stat itemInfo = {};
-    if (::lstat(itemPath.c_str(), &itemInfo) != 0) //lstat() does not resolve symlinks
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(itemPath)), "lstat");
-
-    return {S_ISLNK(itemInfo.st_mode) ? ItemType::symlink : //on Linux there is no distinction between file and directory symlinks!
-            /**/ (S_ISDIR(itemInfo.st_mode) ? ItemType::folder : ItemType::file), //a file or named pipe, etc. => dont't check using S_ISREG(): see comment in file_traverser.cpp
-            itemInfo.st_mtime,
-            makeUnsigned(itemInfo.st_size),
-            getFileFingerprint(itemInfo.st_ino)};
-}
 
 
-FsItemDetails getSymlinkTargetDetails(const Zstring& linkPath) //throw FileError
+//ioScope: run file I/O, e.g. outside of a lock; addFolder: schedule traversal of sub folder
+template <class IoScope, class AddFolder>
+void traverseFolderWithException(const Zstring& dirPath, AFS::TraverserCallback& cb, IoScope ioScope, AddFolder addFolder) //throw FileError, X
 {
-    try
+    std::optional<FolderReader> folder;
+    ioScope([&] { folder.emplace(dirPath); }); //throw FileError
+
+    auto reportItem = [&](const Zstring& itemName, const FsItemDetails& itemDetails) //throw X
     {
-        struct stat itemInfo = {};
-        if (::stat(linkPath.c_str(), &itemInfo) != 0)
-            THROW_LAST_SYS_ERROR("stat");
+        switch (itemDetails.type)
+        {
+            case ItemType::file:
+                cb.onFile({itemName, itemDetails.fileSize, itemDetails.modTime, itemDetails.filePrint, false /*isFollowedSymlink*/}); //throw X
+                break;
+
+            case ItemType::folder: //d_type not available
+                if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({itemName, false /*isFollowedSymlink*/})) //throw X
+                    addFolder(appendSeparator(dirPath) + itemName, std::move(cbSub));
+                break;
+
+            case ItemType::symlink:
+                switch (cb.onSymlink({itemName, itemDetails.modTime})) //throw X
+                {
+                    case AFS::TraverserCallback::HandleLink::follow:
+                    {
+                        FsItemDetails targetDetails = {};
+                        if (!tryReportingItemError([&] //throw X
+                    {
+                        targetDetails = ioScope([&] { return folder->getSymlinkTargetDetails(itemName); }); //throw FileError
+                        }, cb, itemName))
+                        return;
 
-        const ItemType targetType = S_ISDIR(itemInfo.st_mode) ? ItemType::folder : ItemType::file;
+                        if (targetDetails.type == ItemType::folder)
+                        {
+                            if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({itemName, true /*isFollowedSymlink*/})) //throw X
+                                addFolder(appendSeparator(dirPath) + itemName, std::move(cbSub)); //symlink may link to different volume!
+                        }
+                        else //a file or named pipe, etc.
+                            cb.onFile({itemName, targetDetails.fileSize, targetDetails.modTime, targetDetails.filePrint, true /*isFollowedSymlink*/}); //throw X
+                    }
+                    break;
 
-        const AFS::FingerPrint filePrint = targetType == ItemType::folder ? 0 : getFileFingerprint(itemInfo.st_ino);
-        return {targetType,
-                itemInfo.st_mtime,
-                makeUnsigned(itemInfo.st_size),
-                filePrint};
-    }
-    catch (const SysError& e)
+                    case AFS::TraverserCallback::HandleLink::skip:
+                        break;
+                }
+                break;
+        }
+    };
+
+    if (cb.cachesFolderContent())
+        if (const AFS::TraverserCallback::FolderListing* listing = cb.onFolderOpened(ioScope([&] { return folder->getFingerprint(); }))) //throw FileError, X
+        {
+            //folder unchanged: no need to read content or item attributes
+            for (const AFS::FileInfo& fi : listing->files)
+                cb.onFile(fi); //throw X
+
+            for (const AFS::FolderInfo& fi : listing->folders)
+                if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder(fi)) //throw X
+                    addFolder(appendSeparator(dirPath) + fi.itemName, std::move(cbSub));
+
+            for (const AFS::SymlinkInfo& si : listing->symlinks)
+                reportItem(si.itemName, {ItemType::symlink, si.modTime, 0, 0}); //throw X
+            return;
+        }
+
+    std::vector<FsItem> items = ioScope([&] { return folder->getContentFlat(); }); //throw FileError
+
+    //drop excluded items *before* fetching attributes; folders with known d_type need no attributes and are filtered by onFolder()
+    std::erase_if(items, [&](const FsItem& item)
     {
-        throw FileError(replaceCpy(_("Cannot resolve symbolic link %x."), L"%x", fmtPath(linkPath)), e.toString());
+        if (!item.type)
+            return !cb.mayReportItem(item.itemName, std::nullopt);
+        switch (*item.type)
+        {
+            case ItemType::file:
+                return !cb.mayReportItem(item.itemName, AFS::ItemType::file);
+            case ItemType::folder:
+                break;
+            case ItemType::symlink:
+                return !cb.mayReportItem(item.itemName, AFS::ItemType::symlink);
+        }
+        return false;
+    });
+
+    const std::vector<std::optional<FsItemDetails>> prefetched = ioScope([&] { return folder->getItemDetailsBatch(items); }); //noexcept
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const auto& [itemName, itemType] = items[i];
+
+        if (itemType == ItemType::folder) //d_type short-circuit: no need for attributes
+        {
+            if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({itemName, false /*isFollowedSymlink*/})) //throw X
+                addFolder(appendSeparator(dirPath) + itemName, std::move(cbSub));
+            continue;
+        }
+
+        FsItemDetails itemDetails = {};
+        if (!tryReportingItemError([&] //throw X
+    {
+        if (i < prefetched.size() && prefetched[i])
+            itemDetails = *prefetched[i];
+        else
+            itemDetails = ioScope([&] { return folder->getItemDetails(itemName); }); //throw FileError
+        }, cb, itemName))
+        continue; //ignore error: skip file
+
+        reportItem(itemName, itemDetails); //throw X
     }
 }
 
@@ -230,7 +501,8 @@ public:
 
             tryReportingDirError([&] //throw X
             {
-                traverseWithException(wi.dirPath, *wi.cb); //throw FileError, X
+                traverseFolderWithException(wi.dirPath, *wi.cb, [](auto&& fun) { return fun(); }, //throw FileError, X
+                [&](const Zstring& itemPath, std::shared_ptr<AFS::TraverserCallback>&& cbSub) { workload_.push_back({itemPath, std::move(cbSub)}); });
             }, *wi.cb);
         }
     }
@@ -239,60 +511,6 @@ private:
     SingleFolderTraverser           (const SingleFolderTraverser&) = delete;
     SingleFolderTraverser& operator=(const SingleFolderTraverser&) = delete;
 
-    void traverseWithException(const Zstring& dirPath, AFS::TraverserCallback& cb) //throw FileError, X
-    {
-        for (const auto& [itemName] : getDirContentFlat(dirPath)) //throw FileError
-        {
-            const Zstring itemPath = appendSeparator(dirPath) + itemName;
-
-            FsItemDetails itemDetails = {};
-            if (!tryReportingItemError([&] //throw X
-        {
-            itemDetails = getItemDetails(itemPath); //throw FileError
-            }, cb, itemName))
-            continue; //ignore error: skip file
-
-            switch (itemDetails.type)
-            {
-                case ItemType::file:
-                    cb.onFile({itemName, itemDetails.fileSize, itemDetails.modTime, itemDetails.filePrint, false /*isFollowedSymlink*/}); //throw X
-                    break;
-
-                case ItemType::folder:
-                    if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({itemName, false /*isFollowedSymlink*/})) //throw X
-                        workload_.push_back({itemPath, std::move(cbSub)});
-                    break;
-
-                case ItemType::symlink:
-                    switch (cb.onSymlink({itemName, itemDetails.modTime})) //throw X
-                    {
-                        case AFS::TraverserCallback::HandleLink::follow:
-                        {
-                            FsItemDetails targetDetails = {};
-                            if (!tryReportingItemError([&] //throw X
-                        {
-                            targetDetails = getSymlinkTargetDetails(itemPath); //throw FileError
-                            }, cb, itemName))
-                            continue;
-
-                            if (targetDetails.type == ItemType::folder)
-                            {
-                                if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({itemName, true /*isFollowedSymlink*/})) //throw X
-                                    workload_.push_back({itemPath, std::move(cbSub)}); //symlink may link to different volume!
-                            }
-                            else //a file or named pipe, etc.
-                                cb.onFile({itemName, targetDetails.fileSize, targetDetails.modTime, targetDetails.filePrint, true /*isFollowedSymlink*/}); //throw X
-                        }
-                        break;
-
-                        case AFS::TraverserCallback::HandleLink::skip:
-                            break;
-                    }
-                    break;
-            }
-        }
-    }
-
     struct WorkItem
     {
         Zstring dirPath;
@@ -302,9 +520,21 @@ private:
 };
 
 
-void traverseFolderRecursiveNative(const std::vector<std::pair<Zstring, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/, size_t) //throw X
+void traverseFolderRecursiveNative(const std::vector<std::pair<Zstring, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/, size_t parallelOps) //throw X
 {
-    SingleFolderTraverser dummy(workload); //throw X
+    if (parallelOps <= 1)
+    {
+        SingleFolderTraverser dummy(workload); //throw X
+        return;
+    }
+
+    //deep queues on NAS/NVMe: folder reads + lstat() run in parallel, TraverserCallback calls are serialized
+    ParallelFolderTraverser<Zstring> pft(parallelOps);
+    pft.run(workload, [&pft](const Zstring& dirPath, AFS::TraverserCallback& cb, size_t threadIdx) //throw X
+    {
+        traverseFolderWithException(dirPath, cb, [&](auto&& fun) { return pft.parallelScope(fun); }, //throw FileError, X
+        [&](const Zstring& itemPath, std::shared_ptr<AFS::TraverserCallback>&& cbSub) { pft.addFolder(threadIdx, itemPath, std::move(cbSub)); });
+    });
 }
 //====================================================================================================
 //====================================================================================================
@@ -755,6 +755,7 @@ public:
         }
 
         size_t getSftpChannelCount() const { return session_->getSftpChannelCount(); }
+        bool isHealthy() const { return session_->isHealthy(); }
         void markAsCorrupted() { session_->markAsCorrupted(); }
 
         static void addSftpChannel(const std::vector<SshSessionExclusive*>& exSessions) //throw SysError, FatalSshError
@@ -998,6 +999,36 @@ struct SftpItem
     Zstring         itemName;
     SftpItemDetails details;
 };
+void addSftpItem(std::vector<SftpItem>& output, const SftpLogin& login, const AfsPath& dirPath, const std::string_view sftpItemName, const LIBSSH2_SFTP_ATTRIBUTES& attribs) //throw FileError
+{
+    if (sftpItemName == "." || sftpItemName == "..") //check needed for SFTP, too!
+        return;
+
+    const Zstring& itemName = utfTo<Zstring>(sftpItemName);
+    const AfsPath itemPath(nativeAppendPaths(dirPath.value, itemName));
+
+    if ((attribs.flags & LIBSSH2_SFTP_ATTR_PERMISSIONS) == 0) //server probably does not support these attributes => fail at folder level
+        throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"File attributes not available.");
+
+    if (LIBSSH2_SFTP_S_ISLNK(attribs.permissions))
+    {
+        if ((attribs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) == 0) //server probably does not support these attributes => fail at folder level
+            throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"Modification time not supported.");
+        output.push_back({itemName, {AFS::ItemType::symlink, 0, static_cast<time_t>(attribs.mtime)}});
+    }
+    else if (LIBSSH2_SFTP_S_ISDIR(attribs.permissions))
+        output.push_back({itemName, {AFS::ItemType::folder, 0, static_cast<time_t>(attribs.mtime)}});
+    else //a file or named pipe, ect: LIBSSH2_SFTP_S_ISREG, LIBSSH2_SFTP_S_ISCHR, LIBSSH2_SFTP_S_ISBLK, LIBSSH2_SFTP_S_ISFIFO, LIBSSH2_SFTP_S_ISSOCK
+    {
+        if ((attribs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) == 0) //server probably does not support these attributes => fail at folder level
+            throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"Modification time not supported.");
+        if ((attribs.flags & LIBSSH2_SFTP_ATTR_SIZE) == 0)
+            throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"File size not supported.");
+        output.push_back({itemName, {AFS::ItemType::file, attribs.filesize, static_cast<time_t>(attribs.mtime)}});
+    }
+}
+
+
 std::vector<SftpItem> getDirContentFlat(const SftpLogin& login, const AfsPath& dirPath) //throw FileError
 {
     LIBSSH2_SFTP_HANDLE* dirHandle = nullptr;
@@ -1037,33 +1068,7 @@ std::vector<SftpItem> getDirContentFlat(const SftpLogin& login, const AfsPath& d
         if (rc == 0) //no more items
             return output;
 
-        const std::string_view sftpItemName = makeStringView(&buf[0], rc);
-
-        if (sftpItemName == "." || sftpItemName == "..") //check needed for SFTP, too!
-            continue;
-
-        const Zstring& itemName = utfTo<Zstring>(sftpItemName);
-        const AfsPath itemPath(nativeAppendPaths(dirPath.value, itemName));
-
-        if ((attribs.flags & LIBSSH2_SFTP_ATTR_PERMISSIONS) == 0) //server probably does not support these attributes => fail at folder level
-            throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"File attributes not available.");
-
-        if (LIBSSH2_SFTP_S_ISLNK(attribs.permissions))
-        {
-            if ((attribs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) == 0) //server probably does not support these attributes => fail at folder level
-                throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"Modification time not supported.");
-            output.push_back({itemName, {AFS::ItemType::symlink, 0, static_cast<time_t>(attribs.mtime)}});
-        }
-        else if (LIBSSH2_SFTP_S_ISDIR(attribs.permissions))
-            output.push_back({itemName, {AFS::ItemType::folder, 0, static_cast<time_t>(attribs.mtime)}});
-        else //a file or named pipe, ect: LIBSSH2_SFTP_S_ISREG, LIBSSH2_SFTP_S_ISCHR, LIBSSH2_SFTP_S_ISBLK, LIBSSH2_SFTP_S_ISFIFO, LIBSSH2_SFTP_S_ISSOCK
-        {
-            if ((attribs.flags & LIBSSH2_SFTP_ATTR_ACMODTIME) == 0) //server probably does not support these attributes => fail at folder level
-                throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"Modification time not supported.");
-            if ((attribs.flags & LIBSSH2_SFTP_ATTR_SIZE) == 0)
-                throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getSftpDisplayPath(login, itemPath))), L"File size not supported.");
-            output.push_back({itemName, {AFS::ItemType::file, attribs.filesize, static_cast<time_t>(attribs.mtime)}});
-        }
+        addSftpItem(output, login, dirPath, makeStringView(&buf[0], rc), attribs); //throw FileError
     }
 }
 
@@ -1098,24 +1103,25 @@ SftpItemDetails getSymlinkTargetDetails(const SftpLogin& login, const AfsPath& l
 class SingleFolderTraverser
 {
 public:
-    using WorkItem = std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>;
-
-    SingleFolderTraverser(const SftpLogin& login, const std::vector<std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/) :
+    SingleFolderTraverser(const SftpLogin& login, const std::vector<std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/, size_t parallelOps) :
         login_(login)
     {
         for (const auto& [folderPath, cb] : workload)
-            workload_.push_back(WorkItem{folderPath, cb});
+            workload_.push_back(WorkItem{folderPath, cb, 0});
+
+        if (parallelOps > 1 || login_.traverserChannelsPerConnection > 1)
+            traverseAsync(parallelOps); //throw X
 
+        //single channel, or no (more) connections available for asynchronous traversal => blocking traversal
         while (!workload_.empty())
         {
             auto wi = std::move(workload_.    front()); //yes, no strong exception guarantee (std::bad_alloc)
             /**/                workload_.pop_front();  //
-            const auto& [folderPath, cb] = wi;
 
             tryReportingDirError([&] //throw X
             {
-                traverseWithException(folderPath, *cb); //throw FileError, X
-            }, *cb);
+                reportDirContent(wi.folderPath, getDirContentFlat(login_, wi.folderPath), *wi.cb); //throw FileError, X
+            }, *wi.cb);
         }
     }
 
@@ -1123,9 +1129,242 @@ private:
     SingleFolderTraverser           (const SingleFolderTraverser&) = delete;
     SingleFolderTraverser& operator=(const SingleFolderTraverser&) = delete;
 
-    void traverseWithException(const AfsPath& dirPath, AFS::TraverserCallback& cb) //throw FileError, X
+    struct WorkItem
+    {
+        AfsPath folderPath;
+        std::shared_ptr<AFS::TraverserCallback> cb;
+        size_t retryNumber = 0;
+    };
+
+    using SshSessionExclusive = SftpSessionManager::SshSessionExclusive;
+
+    /* folder count in the 100.000s => scan time is dominated by round-trip latency, not bandwidth
+        => keep "connections x channels per connection" libssh2_sftp_opendir/readdir requests in flight
+        - connections: parallelOps (= "Threads" per device), channels: SftpLogin::traverserChannelsPerConnection (see getServerMaxChannelsPerConnection())
+        - all channels are driven non-blocking from the calling thread => TraverserCallback calls are never concurrent
+
+       fatal SSH errors are not reported, but the affected folders are returned to the workload for blocking traversal => proper error reporting + retry    */
+    void traverseAsync(size_t connectionCount) //throw X
+    {
+        const size_t channelsPerConnection = std::max(login_.traverserChannelsPerConnection, 1);
+
+        std::vector<std::unique_ptr<SshSessionExclusive>> exSessions;
+        try
+        {
+            for (size_t i = 0; i < std::max<size_t>(connectionCount, 1); ++i)
+                exSessions.push_back(getExclusiveSftpSession(login_)); //throw SysError
+        }
+        catch (SysError&) {} //e.g. server connection limit: continue with what we have
+
+        //open SFTP channels of all sessions in parallel
+        for (;;)
+        {
+            std::vector<SshSessionExclusive*> sessionsToExtend;
+            for (const std::unique_ptr<SshSessionExclusive>& exSession : exSessions)
+                if (exSession->getSftpChannelCount() < channelsPerConnection)
+                    sessionsToExtend.push_back(exSession.get());
+
+            if (sessionsToExtend.empty())
+                break;
+
+            std::vector<size_t> channelCountOld;
+            for (SshSessionExclusive* exSession : sessionsToExtend)
+                channelCountOld.push_back(exSession->getSftpChannelCount());
+            try
+            {
+                SshSessionExclusive::addSftpChannel(sessionsToExtend); //throw SysError, FatalSshError
+            }
+            catch (SysError&) { break; } //hit the server's channel limit? continue with what we have
+            catch (FatalSshError&)
+            {
+                for (size_t i = 0; i < sessionsToExtend.size(); ++i)
+                    if (sessionsToExtend[i]->getSftpChannelCount() == channelCountOld[i]) //unclear which sessions failed
+                        sessionsToExtend[i]->markAsCorrupted();
+                break;
+            }
+        }
+        std::vector<ChannelSlot> channels;
+        for (const std::unique_ptr<SshSessionExclusive>& exSession : exSessions)
+            if (exSession->isHealthy())
+                for (size_t channelNo = 0; channelNo < std::min(exSession->getSftpChannelCount(), channelsPerConnection); ++channelNo)
+                    channels.push_back({exSession.get(), channelNo});
+
+        for (;;)
+        {
+            for (ChannelSlot& slot : channels)
+                if (slot.exSession && !slot.job && !workload_.empty())
+                {
+                    slot.job = ReadJob{std::move(workload_.front())};
+                    /**/                        workload_.pop_front();
+                }
+
+            bool progress = false;
+            for (ChannelSlot& slot : channels)
+                if (slot.job)
+                    try
+                    {
+                        if (continueReadJob(slot)) //throw FatalSshError, X
+                            progress = true;
+                    }
+                    catch (FatalSshError&)
+                    {
+                        abandonSession(channels, slot.exSession);
+                        progress = true;
+                    }
+
+            if (!progress) //all remaining jobs are pending
+            {
+                std::vector<SshSessionExclusive*> pendingSessions;
+                for (const ChannelSlot& slot : channels)
+                    if (slot.job && std::find(pendingSessions.begin(), pendingSessions.end(), slot.exSession) == pendingSessions.end())
+                        pendingSessions.push_back(slot.exSession);
+
+                if (pendingSessions.empty()) //no work left, or all sessions lost => blocking traversal takes over
+                    return;
+                try
+                {
+                    SshSessionExclusive::waitForTraffic(pendingSessions); //throw FatalSshError
+                }
+                catch (FatalSshError&)
+                {
+                    for (SshSessionExclusive* exSession : pendingSessions)
+                        abandonSession(channels, exSession);
+                }
+            }
+        }
+    }
+
+    struct ReadJob
+    {
+        WorkItem wi;
+        const char* functionName = "libssh2_sftp_opendir";
+        std::chrono::steady_clock::time_point commandStartTime = std::chrono::steady_clock::now();
+        LIBSSH2_SFTP_HANDLE* dirHandle = nullptr;
+        std::vector<SftpItem> items;
+        std::optional<FileError> error;
+    };
+
+    struct ChannelSlot
+    {
+        SshSessionExclusive* exSession; //nullptr if session was lost
+        size_t channelNo;
+        std::optional<ReadJob> job;
+    };
+
+    //return "false" if pending
+    bool continueReadJob(ChannelSlot& slot) //throw FatalSshError, X
+    {
+        ReadJob& job = *slot.job;
+        const AfsPath& dirPath = job.wi.folderPath;
+
+        auto nextCommand = [&](const char* functionName)
+        {
+            job.functionName = functionName;
+            job.commandStartTime = std::chrono::steady_clock::now();
+        };
+
+        if (job.functionName == std::string_view("libssh2_sftp_opendir"))
+        {
+            try
+            {
+                if (!slot.exSession->tryNonBlocking(slot.channelNo, job.commandStartTime, job.functionName, //throw SysError, FatalSshError
+                                                    [&](const SshSession::Details& sd) //noexcept!
+            {
+                job.dirHandle = ::libssh2_sftp_opendir(sd.sftpChannel, getLibssh2Path(dirPath));
+                    if (!job.dirHandle)
+                        return std::min(::libssh2_session_last_errno(sd.sshSession), LIBSSH2_ERROR_SOCKET_NONE);
+                    return LIBSSH2_ERROR_NONE;
+                }))
+                return false;
+
+                nextCommand("libssh2_sftp_readdir");
+                return true;
+            }
+            catch (const SysError& e) { job.error = FileError(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(getSftpDisplayPath(login_, dirPath))), e.toString()); }
+            //=> no directory handle to close
+        }
+        else if (job.functionName == std::string_view("libssh2_sftp_readdir"))
+        {
+            std::array<char, 1024> buf; //libssh2 sample code uses 512; in practice NAME_MAX(255)+1 should suffice
+            LIBSSH2_SFTP_ATTRIBUTES attribs = {};
+            int rc = 0;
+            try
+            {
+                if (!slot.exSession->tryNonBlocking(slot.channelNo, job.commandStartTime, job.functionName, //throw SysError, FatalSshError
+                [&](const SshSession::Details& sd) { return rc = ::libssh2_sftp_readdir(job.dirHandle, &buf[0], buf.size(), &attribs); })) //noexcept!
+                return false;
+
+                if (rc != 0)
+                {
+                    addSftpItem(job.items, login_, dirPath, makeStringView(&buf[0], rc), attribs); //throw FileError
+                    nextCommand("libssh2_sftp_readdir");
+                    return true;
+                }
+            }
+            catch (const SysError&  e) { job.error = FileError(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(getSftpDisplayPath(login_, dirPath))), e.toString()); }
+            catch (const FileError& e) { job.error = e; }
+
+            //report folder content *before* waiting for libssh2_sftp_closedir
+            finishReadJob(job); //throw X
+            nextCommand("libssh2_sftp_closedir");
+            return true;
+        }
+        else
+        {
+            assert(job.functionName == std::string_view("libssh2_sftp_closedir"));
+            try
+            {
+                if (!slot.exSession->tryNonBlocking(slot.channelNo, job.commandStartTime, job.functionName, //throw SysError, FatalSshError
+                [&](const SshSession::Details& sd) { return ::libssh2_sftp_closedir(job.dirHandle); })) //noexcept!
+                return false;
+            }
+            catch (SysError&) {}
+
+            slot.job.reset();
+            return true;
+        }
+
+        finishReadJob(job); //throw X
+        slot.job.reset();
+        return true;
+    }
+
+    void finishReadJob(ReadJob& job) //throw X
+    {
+        if (job.error)
+            switch (job.wi.cb->reportDirError({job.error->toString(), std::chrono::steady_clock::now(), job.wi.retryNumber})) //throw X
+            {
+                case AFS::TraverserCallback::HandleError::ignore:
+                    break;
+                case AFS::TraverserCallback::HandleError::retry:
+                    workload_.push_front(WorkItem{job.wi.folderPath, job.wi.cb, job.wi.retryNumber + 1});
+                    break;
+            }
+        else
+            reportDirContent(job.wi.folderPath, job.items, *job.wi.cb); //throw X
+
+        job.items.clear();
+    }
+
+    //SSH session is broken => return its folders to the workload
+    void abandonSession(std::vector<ChannelSlot>& channels, SshSessionExclusive* exSession)
+    {
+        exSession->markAsCorrupted();
+
+        for (ChannelSlot& slot : channels)
+            if (slot.exSession == exSession)
+            {
+                if (slot.job && slot.job->functionName != std::string_view("libssh2_sftp_closedir")) //folder content not yet reported
+                    workload_.push_front(std::move(slot.job->wi));
+
+                slot.job.reset();
+                slot.exSession = nullptr;
+            }
+    }
+
+    void reportDirContent(const AfsPath& dirPath, const std::vector<SftpItem>& items, AFS::TraverserCallback& cb) //throw X
     {
-        for (const SftpItem& item : getDirContentFlat(login_, dirPath)) //throw FileError
+        for (const SftpItem& item : items)
         {
             const AfsPath itemPath(nativeAppendPaths(dirPath.value, item.itemName));
 
@@ -1137,7 +1376,7 @@ private:
 
                 case AFS::ItemType::folder:
                     if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({item.itemName, false /*isFollowedSymlink*/})) //throw X
-                        workload_.push_back(WorkItem{itemPath, std::move(cbSub)});
+                        workload_.push_back(WorkItem{itemPath, std::move(cbSub), 0});
                     break;
 
                 case AFS::ItemType::symlink:
@@ -1155,7 +1394,7 @@ private:
                             if (targetDetails.type == AFS::ItemType::folder)
                             {
                                 if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb.onFolder({item.itemName, true /*isFollowedSymlink*/})) //throw X
-                                    workload_.push_back(WorkItem{itemPath, std::move(cbSub)});
+                                    workload_.push_back(WorkItem{itemPath, std::move(cbSub), 0});
                             }
                             else //a file or named pipe, etc.
                                 cb.onFile({item.itemName, targetDetails.fileSize, targetDetails.modTime, AFS::FingerPrint() /*not supported by SFTP*/, true /*isFollowedSymlink*/}); //throw X
@@ -1175,9 +1414,9 @@ private:
 };
 
 
-void traverseFolderRecursiveSftp(const SftpLogin& login, const std::vector<std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/, size_t) //throw X
+void traverseFolderRecursiveSftp(const SftpLogin& login, const std::vector<std::pair<AfsPath, std::shared_ptr<AFS::TraverserCallback>>>& workload /*throw X*/, size_t parallelOps) //throw X
 {
-    SingleFolderTraverser dummy(login, workload); //throw X
+    SingleFolderTraverser dummy(login, workload, parallelOps); //throw X
 }
 
 //===========================================================================================================================
@@ -212,7 +212,7 @@ void Application::onQueryEndSession(wxEvent& event)
 
 void runGuiMode  (const Zstring& globalConfigFile);
 void runGuiMode  (const Zstring& globalConfigFile, const XmlGuiConfig& guiCfg, const std::vector<Zstring>& cfgFilePaths, bool startComparison);
-void runBatchMode(const Zstring& globalConfigFile, const XmlBatchConfig& batchCfg, const Zstring& cfgFilePath, FfsExitCode& exitCode);
+void runBatchMode(const Zstring& globalConfigFile, const XmlBatchConfig& batchCfg, const Zstring& cfgFilePath, const Zstring& changeListPath, FfsExitCode& exitCode);
 void showSyntaxHelp();
 
 
@@ -239,10 +239,12 @@ void Application::launch(const std::vector<Zstring>& commandArgs)
     std::vector<std::pair<Zstring, Zstring>> dirPathPhrasePairs;
     std::vector<std::pair<Zstring, XmlType>> configFiles; //XmlType: batch or GUI files only
     Zstring globalConfigFile;
+    Zstring changeListPath; //empty if changes are unknown (RealTimeSync: %change_list%)
     bool openForEdit = false;
     {
-        const char* optionEdit    = "-edit";
-        const char* optionDirPair = "-dirpair";
+        const char* optionEdit       = "-edit";
+        const char* optionDirPair    = "-dirpair";
+        const char* optionChangeList = "-changelist";
         const char* optionSendTo  = "-sendto"; //remaining arguments are unspecified number of folder paths; wonky syntax; let's keep it undocumented
 
         auto isHelpRequest = [](const Zstring& arg)
@@ -260,6 +262,7 @@ void Application::launch(const std::vector<Zstring>& commandArgs)
         {
             return equalAsciiNoCase(arg, optionEdit   ) ||
                    equalAsciiNoCase(arg, optionDirPair) ||
+                   equalAsciiNoCase(arg, optionChangeList) ||
                    equalAsciiNoCase(arg, optionSendTo ) ||
                    isHelpRequest(arg);
         };
@@ -279,6 +282,12 @@ void Application::launch(const std::vector<Zstring>& commandArgs)
                     return notifyFatalError(replaceCpy(_("A left and a right directory path are expected after %x."), L"%x", utfTo<std::wstring>(optionDirPair)), _("Syntax error"));
                 dirPathPhrasePairs.back().second = *it;
             }
+            else if (equalAsciiNoCase(*it, optionChangeList))
+            {
+                if (++it == commandArgs.end() || isCommandLineOption(*it))
+                    return notifyFatalError(replaceCpy(_("A file path is expected after %x."), L"%x", utfTo<std::wstring>(optionChangeList)), _("Syntax error"));
+                changeListPath = *it;
+            }
             else if (equalAsciiNoCase(*it, optionSendTo))
             {
                 for (size_t i = 0; ; ++i)
@@ -431,7 +440,7 @@ void Application::launch(const std::vector<Zstring>& commandArgs)
             }
             if (!replaceDirectories(batchCfg.mainCfg))
                 return;
-            runBatchMode(globalConfigFilePath, batchCfg, filepath, exitCode_);
+            runBatchMode(globalConfigFilePath, batchCfg, filepath, changeListPath, exitCode_);
         }
         //GUI mode: single config (ffs_gui *or* ffs_batch)
         else
@@ -504,6 +513,7 @@ void showSyntaxHelp()
                                                  L"    [" + _("config files:") + L" *.ffs_gui/*.ffs_batch]" + L'\n' +
                                                  L"    [-DirPair " + _("directory") + L' ' + _("directory") + L"]" L"\n" +
                                                  L"    [-Edit]" + L'\n' +
+                                                 L"    [-ChangeList " + _("file") + L"]" + L'\n' +
                                                  L"    [" + _("global config file:") + L" GlobalSettings.xml]" + L"\n\n" +
 
                                                  _("config files:") + L'\n' +
@@ -515,12 +525,15 @@ void showSyntaxHelp()
                                                  L"-Edit" + '\n' +
                                                  _("Open the selected configuration for editing only, without executing it.") + L"\n\n" +
 
+                                                 L"-ChangeList " + _("file") + L'\n' +
+                                                 _("Compare only the folders listed as changed by RealTimeSync (%change_list%).") + L"\n\n" +
+
                                                  _("global config file:") + L'\n' +
                                                  _("Path to an alternate GlobalSettings.xml file.")));
 }
 
 
-void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& batchCfg, const Zstring& cfgFilePath, FfsExitCode& exitCode)
+void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& batchCfg, const Zstring& cfgFilePath, const Zstring& changeListPath, FfsExitCode& exitCode)
 {
     const bool showPopupAllowed = !batchCfg.mainCfg.ignoreErrors && batchCfg.batchExCfg.batchErrorHandling == BatchErrorHandling::showPopup;
 
@@ -603,6 +616,18 @@ void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& bat
         //inform about (important) non-default global settings
         logNonDefaultSettings(globalCfg, statusHandler); //throw AbortProcess
 
+        //RealTimeSync: compare changed folders only
+        std::optional<ChangeList> changes;
+        if (!changeListPath.empty())
+            try
+            {
+                changes = loadChangeList(changeListPath); //throw FileError
+            }
+            catch (const FileError& e) //not critical: fall back to full comparison
+            {
+                statusHandler.logInfo(e.toString()); //throw AbortProcess
+            }
+
         //batch mode: place directory locks on directories during both comparison AND synchronization
         std::unique_ptr<LockHolder> dirLocks;
 
@@ -614,6 +639,8 @@ void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& bat
                                              globalCfg.createLockFile,
                                              dirLocks,
                                              extractCompareCfg(batchCfg.mainCfg),
+                                             changes ? &*changes : nullptr,
+                                             batchCfg.mainCfg.deviceParallelOps,
                                              statusHandler); //throw AbortProcess
         //START SYNCHRONIZATION
         if (!cmpResult.empty())
@@ -276,14 +276,15 @@ bool stillInSync(const InSyncFile& dbFile, CompareVariant compareVar, int fileTi
     switch (compareVar)
     {
         case CompareVariant::timeSize:
-            if (dbFile.cmpVar == CompareVariant::content) return true; //special rule: this is certainly "good enough" for CompareVariant::timeSize!
+            if (dbFile.cmpVar == CompareVariant::content || dbFile.cmpVar == CompareVariant::hash) return true; //special rule: this is certainly "good enough" for CompareVariant::timeSize!
 
             //case-sensitive short name match is a database invariant!
             return sameFileTime(dbFile.left.modTime, dbFile.right.modTime, fileTimeTolerance, ignoreTimeShiftMinutes);
 
         case CompareVariant::content:
+        case CompareVariant::hash:
             //case-sensitive short name match is a database invariant!
-            return dbFile.cmpVar == CompareVariant::content;
+            return dbFile.cmpVar == CompareVariant::content || dbFile.cmpVar == CompareVariant::hash;
         //in contrast to comparison, we don't care about modification time here!
 
         case CompareVariant::size: //file size/case-sensitive short name always matches on both sides for an "in-sync" database entry
@@ -317,16 +318,17 @@ bool stillInSync(const InSyncSymlink& dbLink, CompareVariant compareVar, int fil
     switch (compareVar)
     {
         case CompareVariant::timeSize:
-            if (dbLink.cmpVar == CompareVariant::content || dbLink.cmpVar == CompareVariant::size)
+            if (dbLink.cmpVar == CompareVariant::content || dbLink.cmpVar == CompareVariant::hash || dbLink.cmpVar == CompareVariant::size)
                 return true; //special rule: this is already "good enough" for CompareVariant::timeSize!
 
             //case-sensitive short name match is a database invariant!
             return sameFileTime(dbLink.left.modTime, dbLink.right.modTime, fileTimeTolerance, ignoreTimeShiftMinutes);
 
         case CompareVariant::content:
+        case CompareVariant::hash:
         case CompareVariant::size: //== categorized by content! see comparison.cpp, ComparisonBuffer::compareBySize()
             //case-sensitive short name match is a database invariant!
-            return dbLink.cmpVar == CompareVariant::content || dbLink.cmpVar == CompareVariant::size;
+            return dbLink.cmpVar == CompareVariant::content || dbLink.cmpVar == CompareVariant::hash || dbLink.cmpVar == CompareVariant::size;
     }
     assert(false);
     return false;
@@ -787,12 +789,20 @@ std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>> fff::extractDirecti
 
 void fff::redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
                                    PhaseCallback& callback /*throw X*/) //throw X
+{
+    redetermineSyncDirection(directCfgs, {} /*preloadedSyncStates*/, callback); //throw X
+}
+
+
+void fff::redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
+                                   std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>>&& preloadedSyncStates,
+                                   PhaseCallback& callback /*throw X*/) //throw X
 {
     if (directCfgs.empty())
         return;
 
     std::unordered_set<const BaseFolderPair*> allEqualPairs;
-    std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates;
+    std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates = std::move(preloadedSyncStates);
 
     //best effort: always set sync directions (even on DB load error and when user cancels during file loading)
     ZEN_ON_SCOPE_EXIT
@@ -837,13 +847,14 @@ void fff::redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*,
         {
             if (allItemsCategoryEqual(*baseFolder)) //nothing to do: don't even try to open DB files
                 allEqualPairs.insert(baseFolder);
-            else
+            else if (!lastSyncStates.contains(baseFolder))
                 baseFoldersForDbLoad.push_back(baseFolder);
         }
 
     //(try to) load sync-database files
-    lastSyncStates = loadLastSynchronousState(baseFoldersForDbLoad,
-                                              callback /*throw X*/); //throw X
+    if (!baseFoldersForDbLoad.empty())
+        lastSyncStates.merge(loadLastSynchronousState(baseFoldersForDbLoad,
+                                                      callback /*throw X*/)); //throw X
 
     callback.updateStatus(_("Calculating sync directions...")); //throw X
     callback.requestUiUpdate(true /*force*/); //throw X
@@ -9,6 +9,7 @@
 
 #include <functional>
 #include <span>
+#include <unordered_map>
 #include "structures.h"
 #include "file_hierarchy.h"
 #include "soft_filter.h"
@@ -30,6 +31,12 @@ std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>> extractDirectionCfg
 void redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
                               PhaseCallback& callback /*throw X*/); //throw X
 
+struct InSyncFolder;
+//preloadedSyncStates: sync.ffs_db content already loaded during comparison => don't load again
+void redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
+                              std::unordered_map<const BaseFolderPair*, zen::SharedRef<const InSyncFolder>>&& preloadedSyncStates,
+                              PhaseCallback& callback /*throw X*/); //throw X
+
 void setSyncDirectionRec(SyncDirection newDirection, FileSystemObject& fsObj); //set new direction (recursively)
 
 bool allElementsEqual(const FolderComparison& folderCmp);
@@ -7,6 +7,8 @@
 #include "binary.h"
 #include <vector>
 #include <chrono>
+#include <zen/open_ssl.h>
+#include "../afs/abstract_impl.h"
 
 using namespace zen;
 using namespace fff;
@@ -40,7 +42,10 @@ const size_t BLOCK_SIZE_MAX =  16 * 1024 * 1024;
 struct StreamReader
 {
     StreamReader(const AbstractPath& filePath, const IoCallback& notifyUnbufferedIO) : //throw FileError
-        stream_(AFS::getInputStream(filePath, notifyUnbufferedIO)), //throw FileError, ErrorFileLocked
+        StreamReader(AFS::getInputStream(filePath, notifyUnbufferedIO)) {} //throw FileError, ErrorFileLocked
+
+    explicit StreamReader(std::unique_ptr<AFS::InputStream>&& stream) :
+        stream_(std::move(stream)),
         defaultBlockSize_(stream_->getBlockSize()),
         dynamicBlockSize_(defaultBlockSize_) { assert(defaultBlockSize_ > 0); }
 
@@ -91,18 +96,87 @@ private:
     std::chrono::steady_clock::time_point lastDelayViolation_ = std::chrono::steady_clock::now();
     bool eof_ = false;
 };
-}
 
 
-bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+/* read-ahead: read the file on a worker thread while the consumer compares
+    => both devices are busy at the same time instead of taking turns
+    => bounded memory: worker may be at most one chunk + 2 blocks ahead (double buffer) */
+class AsyncStreamReader
 {
-    int64_t totalUnbufferedIO = 0;
+public:
+    AsyncStreamReader(const AbstractPath& filePath, const IoCallback& notifyUnbufferedIO) : //throw FileError
+        notifyUnbufferedIO_(notifyUnbufferedIO)
+    {
+        //callback must not run on worker thread (not thread-safe, throws ThreadStopRequest of *our* thread) => report bytes once consumed
+        std::unique_ptr<AFS::InputStream> stream = AFS::getInputStream(filePath, nullptr /*notifyUnbufferedIO*/); //throw FileError, ErrorFileLocked
+        blockSize_ = stream->getBlockSize();
+        asyncStream_ = std::make_shared<AsyncStreamBuffer>(2 * blockSize_);
+
+        worker_ = InterruptibleThread([asyncStreamOut = asyncStream_, stream = std::move(stream), threadName = Zstr("Read-ahead ") + utfTo<Zstring>(AFS::getDisplayPath(filePath))]() mutable
+        {
+            setCurrentThreadName(threadName);
+            try
+            {
+                StreamReader reader(std::move(stream)); //dynamic block size: still relevant for high-latency devices
+
+                std::vector<std::byte> buffer;
+                do
+                {
+                    reader.appendChunk(buffer); //throw FileError, ErrorFileLocked
+                    asyncStreamOut->write(buffer.data(), buffer.size()); //throw ThreadStopRequest
+                    buffer.clear();
+                }
+                while (!reader.isEof());
+
+                asyncStreamOut->closeStream();
+            }
+            catch (FileError&) { asyncStreamOut->setWriteError(std::current_exception()); } //let ThreadStopRequest pass through!
+        });
+    }
+
+    ~AsyncStreamReader()
+    {
+        asyncStream_->setReadError(std::make_exception_ptr(ThreadStopRequest())); //e.g. early return on first mismatch: stop worker
+    }
+
+    void appendChunk(std::vector<std::byte>& buffer) //throw FileError, X
+    {
+        assert(!eof_);
+        if (eof_) return;
+
+        buffer.resize(buffer.size() + blockSize_);
+        const size_t bytesRead = asyncStream_->read(&*(buffer.end() - blockSize_), blockSize_); //throw FileError, ErrorFileLocked; return "bytesToRead" bytes unless end of stream!
+        buffer.resize(buffer.size() - blockSize_ + bytesRead); //caveat: unsigned arithmetics
+
+        if (bytesRead < blockSize_)
+            eof_ = true;
+
+        //report consumed bytes only: worker may be ahead
+        if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesRead); //throw X
+    }
+
+    bool isEof() const { return eof_; }
+
+private:
+    AsyncStreamReader           (const AsyncStreamReader&) = delete;
+    AsyncStreamReader& operator=(const AsyncStreamReader&) = delete;
+
+    const IoCallback notifyUnbufferedIO_; //throw X
+    size_t blockSize_ = 0;
+    bool eof_ = false;
+    std::shared_ptr<AsyncStreamBuffer> asyncStream_;
+    InterruptibleThread worker_;
+};
 
-    StreamReader reader1(filePath1, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError
-    StreamReader reader2(filePath2, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //
 
-    StreamReader* readerLow  = &reader1;
-    StreamReader* readerHigh = &reader2;
+static_assert(std::is_same_v<ContentHash, Sha256::Digest>);
+
+
+template <class Reader>
+bool haveSameContent(Reader& reader1, Reader& reader2, Sha256* hasher /*optional*/) //throw FileError, SysError, X
+{
+    Reader* readerLow  = &reader1;
+    Reader* readerHigh = &reader2;
 
     std::vector<std::byte> bufferLow;
     std::vector<std::byte> bufferHigh;
@@ -121,12 +195,15 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
                         bufferHigh.begin()))
             return false;
 
+        if (hasher) //hash while data is hot in cache
+            hasher->update(bufferLow.data(), bufferLow.size()); //throw SysError
+
         if (readerLow->isEof())
         {
             if (bufferLow.size() < bufferHigh.size())
                 return false;
             if (readerHigh->isEof())
-                break;
+                return true;
             //bufferLow.swap(bufferHigh); not needed
             std::swap(readerLow, readerHigh);
         }
@@ -135,9 +212,74 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
         bufferHigh.erase(bufferHigh.begin(), bufferHigh.begin() + bufferLow.size());
         bufferLow.clear();
     }
+}
+}
 
-    if (totalUnbufferedIO % 2 != 0)
-        throw std::logic_error("Contract violation! " + std::string(__FILE__) + ':' + numberTo<std::string>(__LINE__));
 
-    return true;
+bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IoCallback& notifyUnbufferedIO /*throw X*/, //throw FileError, X
+                                ContentHash* contentHash)
+{
+    try
+    {
+        int64_t totalUnbufferedIO = 0;
+
+        std::optional<Sha256> hasher;
+        if (contentHash)
+            hasher.emplace(); //throw SysError
+
+        //files on the same device: concurrent reads would only add seeks on spinning disks => read alternately
+        const bool readAhead = filePath1.afsDevice != filePath2.afsDevice;
+
+        const bool sameContent = [&]
+        {
+            if (readAhead)
+            {
+                AsyncStreamReader reader1(filePath1, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError
+                AsyncStreamReader reader2(filePath2, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //
+                return haveSameContent(reader1, reader2, hasher ? &*hasher : nullptr); //throw FileError, SysError, X
+            }
+            else
+            {
+                StreamReader reader1(filePath1, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError
+                StreamReader reader2(filePath2, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //
+                return haveSameContent(reader1, reader2, hasher ? &*hasher : nullptr); //throw FileError, SysError, X
+            }
+        }();
+
+        if (sameContent && totalUnbufferedIO % 2 != 0)
+            throw std::logic_error("Contract violation! " + std::string(__FILE__) + ':' + numberTo<std::string>(__LINE__));
+
+        if (sameContent && contentHash)
+            *contentHash = hasher->finalize(); //throw SysError
+
+        return sameContent;
+    }
+    catch (const SysError& e) //content hash: not specific to either file (read errors are reported as FileError)
+    {
+        throw FileError(replaceCpy(replaceCpy(_("Cannot compare content of files %x and %y."),
+                                              L"%x", L'\n' + fmtPath(AFS::getDisplayPath(filePath1))),
+                                   L"%y", L'\n' + fmtPath(AFS::getDisplayPath(filePath2))), e.toString());
+    }
+}
+
+
+ContentHash fff::getContentHash(const AbstractPath& filePath, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+{
+    try
+    {
+        Sha256 hasher; //throw SysError
+        StreamReader reader(filePath, notifyUnbufferedIO); //throw FileError
+
+        std::vector<std::byte> buffer;
+        do
+        {
+            reader.appendChunk(buffer); //throw FileError, X
+            hasher.update(buffer.data(), buffer.size()); //throw SysError
+            buffer.clear();
+        }
+        while (!reader.isEof());
+
+        return hasher.finalize(); //throw SysError
+    }
+    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(AFS::getDisplayPath(filePath))), e.toString()); }
 }
@@ -8,13 +8,17 @@
 #define BINARY_H_3941281398513241134
 
 #include "../afs/abstract.h"
+#include "file_hierarchy.h"
 
 
 namespace fff
 {
 bool filesHaveSameContent(const AbstractPath& filePath1, //throw FileError, X
                           const AbstractPath& filePath2,
-                          const zen::IoCallback& notifyUnbufferedIO  /*throw X*/);
+                          const zen::IoCallback& notifyUnbufferedIO  /*throw X*/,
+                          ContentHash* contentHash /*optional: set if same content*/);
+
+ContentHash getContentHash(const AbstractPath& filePath, const zen::IoCallback& notifyUnbufferedIO /*throw X*/); //throw FileError, X
 }
 
 #endif //BINARY_H_3941281398513241134
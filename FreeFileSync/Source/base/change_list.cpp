@@ -0,0 +1,77 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "change_list.h"
+#include <zen/file_io.h>
+
+using namespace zen;
+using namespace fff;
+
+
+namespace
+{
+/* plain text, UTF-8, one item per line:
+        FreeFileSync Change List 1
+        W   <watched folder path>
+        C   <changed item path>                  */
+const char CHANGE_LIST_HEADER[] = "FreeFileSync Change List 1";
+const char PREFIX_WATCHED = 'W';
+const char PREFIX_CHANGED = 'C';
+}
+
+
+void fff::saveChangeList(const ChangeList& changes, const Zstring& filePath) //throw FileError
+{
+    std::string buf = CHANGE_LIST_HEADER;
+    buf += '\n';
+
+    auto writeLine = [&](char prefix, const Zstring& itemPath)
+    {
+        if (contains(itemPath, Zstr('\n'))) //Linux: file names may contain line breaks!
+            throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(filePath)),
+                            replaceCpy<std::wstring>(L"Unsupported item name: %x", L"%x", fmtPath(itemPath)));
+        buf += prefix;
+        buf += '\t';
+        buf += utfTo<std::string>(itemPath);
+        buf += '\n';
+    };
+    for (const Zstring& folderPath : changes.watchedFolders) writeLine(PREFIX_WATCHED, folderPath);
+    for (const Zstring& itemPath   : changes.changedItems)   writeLine(PREFIX_CHANGED, itemPath);
+
+    setFileContent(filePath, buf, nullptr /*notifyUnbufferedIO*/); //throw FileError
+}
+
+
+ChangeList fff::loadChangeList(const Zstring& filePath) //throw FileError
+{
+    const std::string buf = getFileContent(filePath, nullptr /*notifyUnbufferedIO*/); //throw FileError
+
+    std::vector<std::string> lines = split(buf, '\n', SplitOnEmpty::skip);
+
+    if (lines.empty() || lines[0] != CHANGE_LIST_HEADER)
+        throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(filePath)), _("File content is corrupted.") + L" (invalid header)");
+
+    ChangeList changes;
+    for (auto it = lines.begin() + 1; it != lines.end(); ++it)
+    {
+        if (it->size() < 3 || (*it)[1] != '\t')
+            throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(filePath)), _("File content is corrupted.") + L" (invalid line)");
+
+        const Zstring itemPath = utfTo<Zstring>(it->substr(2));
+        switch ((*it)[0])
+        {
+            case PREFIX_WATCHED:
+                changes.watchedFolders.insert(itemPath);
+                break;
+            case PREFIX_CHANGED:
+                changes.changedItems.insert(itemPath);
+                break;
+            default:
+                throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(filePath)), _("File content is corrupted.") + L" (invalid line)");
+        }
+    }
+    return changes;
+}
@@ -0,0 +1,32 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef CHANGE_LIST_H_8034751938475629384
+#define CHANGE_LIST_H_8034751938475629384
+
+#include <set>
+#include <zen/file_error.h>
+
+
+namespace fff
+{
+/* RealTimeSync -> FreeFileSync: which items were changed since the last sync?
+    - passed via command line: FreeFileSync.exe "SyncJob.ffs_batch" -ChangeList "%change_list%"
+    - RealTimeSync sets %change_list% to an empty string if changes are not known completely, e.g. first run, folder temporarily unavailable
+    - FreeFileSync reads only changed sub folders and takes the rest from sync.ffs_db: see compare()
+
+   CAVEAT: changes *not* within a watched folder are invisible => base folders not contained in a watched folder are compared as usual */
+struct ChangeList
+{
+    std::set<Zstring> watchedFolders; //native paths (all sub folders are watched, too)
+    std::set<Zstring> changedItems;   //native paths: created, modified, deleted, renamed (old and new name); watched folder itself: everything may have changed
+};
+
+void       saveChangeList(const ChangeList& changes, const Zstring& filePath); //throw FileError
+ChangeList loadChangeList(const Zstring& filePath); //throw FileError
+}
+
+#endif //CHANGE_LIST_H_8034751938475629384
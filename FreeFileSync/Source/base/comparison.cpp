@@ -5,9 +5,12 @@
 // *****************************************************************************
 
 #include "comparison.h"
+#include <deque>
+#include <variant>
 #include <zen/process_priority.h>
 #include <zen/perf.h>
 #include <zen/time.h>
+#include <zen/file_access.h>
 #include <wx/datetime.h>
 #include "algorithm.h"
 #include "parallel_scan.h"
@@ -48,7 +51,9 @@ std::vector<FolderPairCfg> fff::extractCompareCfg(const MainConfiguration& mainC
             cmpCfg.handleSymlinks,
             cmpCfg.ignoreTimeShiftMinutes,
             filter,
-            syncCfg.directionCfg
+            syncCfg.directionCfg,
+            mainCfg.scanCache,
+            mainCfg.pruneSoftFiltered
         });
     }
     return output;
@@ -152,47 +157,399 @@ ResolvedBaseFolders initializeBaseFolders(const std::vector<FolderPairCfg>& fpCf
 
 //#############################################################################################################################
 
+DirectoryKey getDirectoryKey(const AbstractPath& folderPath, const FolderPairCfg& fpCfg)
+{
+    return {folderPath, fpCfg.filter.nameFilter, fpCfg.handleSymlinks, fpCfg.scanCache};
+}
+
+
+//-------------------------------------------------------------------------------------------------------------------------------
+
+//incremental comparison: (re-)read changed folders only, take the rest from the last synchronous state
+struct IncrementalRead
+{
+    std::vector<SubFolderRead> folderReads; //may be empty: nothing changed
+    zen::SharedRef<const InSyncFolder> lastSyncState;
+    SelectSide side;
+};
+
+
+//changes are invisible for folders that are not watched completely: e.g. symlinks are not followed by DirWatcher
+bool isWatchedFolder(const Zstring& folderPath, const std::set<Zstring>& watchedFolders) //file I/O: don't call from main thread!
+{
+    for (const Zstring& watchedPath : watchedFolders)
+        if (folderPath == watchedPath)
+            return true;
+        else if (startsWith(folderPath, appendSeparator(watchedPath)))
+        {
+            for (Zstring parentPath = folderPath; parentPath != watchedPath;
+                 parentPath = beforeLast(parentPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none))
+                try
+                {
+                    if (getItemType(parentPath) != ItemType::folder) //throw FileError
+                        return false;
+                }
+                catch (FileError&) { return false; }
+            return true;
+        }
+    return false;
+}
+
+
+//nullopt: read complete base folder
+std::optional<std::vector<SubFolderRead>> getChangedFolderReads(const Zstring& baseFolderPath, const InSyncFolder& dbFolder, const std::set<Zstring>& changedItems, //file I/O: don't call from main thread!
+                                                                const PathFilter& filter)
+{
+    std::map<Zstring, bool> existingFolders; //buffer: parent folders are shared by many changed items
+
+    auto isExistingFolder = [&](const Zstring& relPath)
+    {
+        if (relPath.empty())
+            return true; //base folder existence was checked already
+
+        auto [it, inserted] = existingFolders.emplace(relPath, false);
+        if (inserted)
+            try
+            {
+                it->second = getItemType(nativeAppendPaths(baseFolderPath, relPath)) == ItemType::folder; //throw FileError
+            }
+            catch (FileError&) {} //not existing (or access error => parent folder is read instead)
+        return it->second;
+    };
+
+    std::map<Zstring, bool /*recursive*/> folderReads; //relative paths
+
+    auto addChangedItem = [&](const Zstring& relPath)
+    {
+        //new folder (e.g. moved in from elsewhere) => contents not yet known
+        if (isExistingFolder(relPath))
+            folderReads[relPath] = true;
+
+        //parent folder: which items were added, removed, modified?
+        Zstring parentRelPath = beforeLast(relPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none);
+        while (!isExistingFolder(parentRelPath)) //parent was deleted, too
+            parentRelPath = beforeLast(parentRelPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none);
+
+        folderReads.emplace(parentRelPath, false); //don't downgrade a recursive read
+    };
+
+    const Zstring baseFolderPathPf = appendSeparator(baseFolderPath);
+
+    for (const Zstring& itemPath : changedItems)
+        if (itemPath == baseFolderPath || startsWith(baseFolderPathPf, appendSeparator(itemPath))) //base folder or parent folders changed
+            return std::nullopt;
+        else if (startsWith(itemPath, baseFolderPathPf))
+            addChangedItem(Zstring(itemPath.begin() + baseFolderPathPf.size(), itemPath.end()));
+
+    //straw man folders have no last synchronous state of their own => can't take them from sync.ffs_db
+    std::function<void(const InSyncFolder& dbFolder, const Zstring& relPathPf)> findStrawMen;
+    findStrawMen = [&](const InSyncFolder& dbFolder2, const Zstring& relPathPf)
+    {
+        for (const auto& [folderName, dbSubFolder] : dbFolder2.folders)
+            if (dbSubFolder.status == InSyncFolder::DIR_STATUS_STRAW_MAN)
+                addChangedItem(relPathPf + folderName);
+            else
+                findStrawMen(dbSubFolder, relPathPf + folderName + FILE_NAME_SEPARATOR);
+    };
+    findStrawMen(dbFolder, Zstring());
+
+    if (auto it = folderReads.find(Zstring()); it != folderReads.end() && it->second)
+        return std::nullopt;
+
+    std::vector<SubFolderRead> output;
+    for (const auto& [relPath, recursive] : folderReads)
+    {
+        bool skipRead = false;
+        for (Zstring parentRelPath = relPath; !skipRead && !parentRelPath.empty(); )
+        {
+            bool childItemMightMatch = true;
+            if (!filter.passDirFilter(parentRelPath, &childItemMightMatch) && !childItemMightMatch)
+                skipRead = true; //excluded via filter
+
+            parentRelPath = beforeLast(parentRelPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none);
+
+            if (auto it = folderReads.find(parentRelPath); it != folderReads.end() && it->second)
+                skipRead = true; //read by recursive parent read
+        }
+        if (!skipRead)
+            output.push_back({relPath, recursive});
+    }
+    return output;
+}
+
+
+std::map<DirectoryKey, IncrementalRead> getIncrementalReads(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad, const FolderStatus& folderStatus,
+                                                            int fileTimeTolerance, const ChangeList& changes, PhaseCallback& callback /*throw X*/) //throw X
+{
+    //a folder read by multiple folder pairs: its content must be complete for all of them
+    std::map<AbstractPath, int> folderPathUsage;
+    for (const auto& [folderPair, fpCfg] : workLoad)
+    {
+        ++folderPathUsage[folderPair.folderPathLeft];
+        ++folderPathUsage[folderPair.folderPathRight];
+    }
+
+    std::vector<std::shared_ptr<const BaseFolderPair>> baseFolders;
+    std::vector<std::pair<const BaseFolderPair*, const FolderPairCfg*>> candidates;
+
+    for (const auto& [folderPair, fpCfg] : workLoad)
+        if (fpCfg.compareVar != CompareVariant::content && //file content is not part of sync.ffs_db
+            fpCfg.compareVar != CompareVariant::hash    && //
+            fpCfg.handleSymlinks != SymLinkHandling::follow &&
+            fpCfg.directionCfg.var == SyncVariant::twoWay && //each difference is synced or reported as conflict; other variants: sync.ffs_db keeps the old state of
+            //items that are not synced (e.g. direction "none") => unchanged folders would show them as "equal" and the difference would be lost
+            folderStatus.existing.contains(folderPair.folderPathLeft) &&
+            folderStatus.existing.contains(folderPair.folderPathRight) &&
+            (folderPathUsage[folderPair.folderPathLeft ] == 1 || folderPathUsage[folderPair.folderPathRight] == 1))
+        {
+            const auto& baseFolder = baseFolders.emplace_back(std::make_shared<BaseFolderPair>(folderPair.folderPathLeft,  BaseFolderStatus::existing,
+                                                                                               folderPair.folderPathRight, BaseFolderStatus::existing,
+                                                                                               fpCfg.filter.nameFilter, fpCfg.compareVar, fileTimeTolerance,
+                                                                                               fpCfg.ignoreTimeShiftMinutes));
+            candidates.emplace_back(baseFolder.get(), &fpCfg);
+        }
+
+    if (candidates.empty())
+        return {};
+
+    std::vector<const BaseFolderPair*> baseFoldersForDbLoad;
+    for (const auto& [baseFolder, fpCfg] : candidates)
+        baseFoldersForDbLoad.push_back(baseFolder);
+
+    std::unordered_map<const BaseFolderPair*, uint64_t> cfgFingerprints;
+    const std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates = loadLastSynchronousState(baseFoldersForDbLoad, callback, //throw X
+                                                                                           &cfgFingerprints);
+    struct SideCheck
+    {
+        DirectoryKey dirKey;
+        SharedRef<const InSyncFolder> lastSyncState;
+        SelectSide side;
+        std::future<std::optional<std::vector<SubFolderRead>>> folderReads;
+    };
+    std::vector<SideCheck> sideChecks;
+
+    //don't block the main thread with file I/O for each changed item
+    const auto changesShared = std::make_shared<const ChangeList>(changes); //runAsync() threads are detached: may outlive "changes"!
+
+    for (const auto& [baseFolder, fpCfg] : candidates)
+        if (auto itDb = lastSyncStates.find(baseFolder);
+            itDb != lastSyncStates.end())
+        {
+            //items of unchanged folders are taken from sync.ffs_db => it must have been recorded with the same filter, compare variant and symlink handling
+            if (auto itFp = cfgFingerprints.find(baseFolder);
+                itFp == cfgFingerprints.end() || //older database version
+                itFp->second != getDbConfigFingerprint(fpCfg->filter.nameFilter.ref(), fpCfg->compareVar, fpCfg->handleSymlinks))
+                continue;
+
+            auto addSide = [&, &fpCfg = *fpCfg](SelectSide side, const AbstractPath& folderPath)
+            {
+                if (folderPathUsage[folderPath] != 1)
+                    return;
+
+                if (const Zstring& nativePath = getNativeItemPath(folderPath);
+                    !nativePath.empty())
+                    sideChecks.push_back(
+                {
+                    getDirectoryKey(folderPath, fpCfg), itDb->second, side,
+                    runAsync([nativePath, lastSyncState = itDb->second, changesShared, filter = fpCfg.filter.nameFilter]
+                    {
+                        setCurrentThreadName(Zstr("Incremental comparison"));
+
+                        if (!isWatchedFolder(nativePath, changesShared->watchedFolders))
+                            return std::optional<std::vector<SubFolderRead>>();
+
+                        return getChangedFolderReads(nativePath, lastSyncState.ref(), changesShared->changedItems, filter.ref());
+                    })
+                });
+            };
+            addSide(SelectSide::left,  baseFolder->getAbstractPath<SelectSide::left >());
+            addSide(SelectSide::right, baseFolder->getAbstractPath<SelectSide::right>());
+        }
+
+    std::map<DirectoryKey, IncrementalRead> output;
+
+    for (SideCheck& sc : sideChecks)
+    {
+        while (sc.folderReads.wait_for(UI_UPDATE_INTERVAL / 2) == std::future_status::timeout)
+            callback.requestUiUpdate(); //throw X
+
+        if (std::optional<std::vector<SubFolderRead>> folderReads = sc.folderReads.get())
+        {
+            callback.logInfo(replaceCpy(_("Comparing changed folders only: %x"), L"%x", fmtPath(AFS::getDisplayPath(sc.dirKey.folderPath)))); //throw X
+
+            output.emplace(sc.dirKey, IncrementalRead{std::move(*folderReads), sc.lastSyncState, sc.side});
+        }
+    }
+
+    return output;
+}
+
+
+//complete folder content by adding the items of unchanged folders from the last synchronous state
+template <SelectSide side>
+void addLastSyncState(FolderContainer& folderCont, const InSyncFolder& dbFolder, const Zstring& relPath,
+                      const std::map<Zstring, bool /*recursive*/>& folderReads, const PathFilter& filter, SymLinkHandling handleSymlinks)
+{
+    const auto itRead = folderReads.find(relPath);
+    if (itRead != folderReads.end() && itRead->second) //recursive read: up to date
+        return;
+
+    const Zstring relPathPf = relPath.empty() ? Zstring() : relPath + FILE_NAME_SEPARATOR;
+
+    if (itRead == folderReads.end()) //unchanged folder
+    {
+        for (const auto& [fileName, dbFile] : dbFolder.files)
+            if (filter.passFileFilter(relPathPf + fileName))
+            {
+                const InSyncDescrFile& descr = SelectParam<side>::ref(dbFile.left, dbFile.right);
+                folderCont.addSubFile(fileName, FileAttributes(descr.modTime, dbFile.fileSize, descr.filePrint, false /*isFollowedSymlink*/));
+            }
+
+        if (handleSymlinks == SymLinkHandling::direct)
+            for (const auto& [linkName, dbSymlink] : dbFolder.symlinks)
+                if (filter.passFileFilter(relPathPf + linkName))
+                    folderCont.addSubLink(linkName, LinkAttributes(SelectParam<side>::ref(dbSymlink.left, dbSymlink.right).modTime));
+    }
+
+    //unchanged folder: contains parent folders of sub folder reads only
+    std::map<Zstring, FolderContainer*> existingFolders;
+    if (itRead == folderReads.end())
+        for (auto& folder : folderCont.folders)
+            existingFolders.emplace(folder.itemName, &folder.value->cont);
+
+    for (const auto& [folderName, dbSubFolder] : dbFolder.folders)
+    {
+        const Zstring& subRelPath = relPathPf + folderName;
+        FolderContainer* subFolderCont = nullptr;
+
+        if (itRead == folderReads.end()) //unchanged folder
+        {
+            bool childItemMightMatch = true;
+            if (!filter.passDirFilter(subRelPath, &childItemMightMatch) && !childItemMightMatch)
+                continue;
+
+            if (auto it = existingFolders.find(folderName); it != existingFolders.end())
+                subFolderCont = it->second;
+            else
+                subFolderCont = &folderCont.addSubFolder(folderName, FolderAttributes(false /*isFollowedSymlink*/));
+        }
+        else //folder was read non-recursively: sub folders not found anymore have been deleted
+        {
+            auto it = std::find_if(folderCont.folders.begin(), folderCont.folders.end(), [&](const auto& item)
+            { return !LessUnicodeNormal()(item.itemName, folderName) && !LessUnicodeNormal()(folderName, item.itemName); }); //db ignores Unicode normal forms
+            if (it == folderCont.folders.end())
+                continue;
+            subFolderCont = &it->value->cont;
+        }
+        addLastSyncState<side>(*subFolderCont, dbSubFolder, subRelPath, folderReads, filter, handleSymlinks);
+    }
+}
+
+
+void addLastSyncState(FolderContainer& folderCont, const IncrementalRead& incRead, const PathFilter& filter, SymLinkHandling handleSymlinks)
+{
+    std::map<Zstring, bool> folderReads;
+    for (const SubFolderRead& subRead : incRead.folderReads)
+        folderReads.emplace(subRead.relPath, subRead.recursive);
+
+    if (incRead.side == SelectSide::left)
+        addLastSyncState<SelectSide::left >(folderCont, incRead.lastSyncState.ref(), Zstring(), folderReads, filter, handleSymlinks);
+    else
+        addLastSyncState<SelectSide::right>(folderCont, incRead.lastSyncState.ref(), Zstring(), folderReads, filter, handleSymlinks);
+}
+
+//-------------------------------------------------------------------------------------------------------------------------------
+
+/* pipeline: compare a folder pair as soon as both sides are read
+    => overlap CPU-bound matching with I/O-bound traversal of other devices
+    => free raw folder content as soon as all folder pairs using it are compared: lower peak memory      */
 class ComparisonBuffer
 {
 public:
-    ComparisonBuffer(const std::set<DirectoryKey>& folderKeys,
+    ComparisonBuffer(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad,
                      const FolderStatus& baseFolderStatus,
+                     const std::map<DirectoryKey, IncrementalRead>& incrementalReads,
+                     const std::map<AfsDevice, size_t>& deviceParallelOps,
                      int fileTimeTolerance,
                      ProcessCallback& callback);
 
-    //create comparison result table and fill category except for files existing on both sides: undefinedFiles and undefinedSymlinks are appended!
-    std::shared_ptr<BaseFolderPair> compareByTimeSize(const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const;
-    std::shared_ptr<BaseFolderPair> compareBySize    (const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const;
-    std::list<std::shared_ptr<BaseFolderPair>> compareByContent(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad) const;
+    //finish categorization of files existing on both sides (CompareVariant::content, CompareVariant::hash) => output in workload order
+    //lastSyncStates: sync.ffs_db content loaded during comparison => reuse for redetermineSyncDirection()
+    FolderComparison finishComparison(std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>>& lastSyncStates); //throw X
 
 private:
     ComparisonBuffer           (const ComparisonBuffer&) = delete;
     ComparisonBuffer& operator=(const ComparisonBuffer&) = delete;
 
+    void onFolderRead(std::map<DirectoryKey, DirectoryValue>::node_type&& folderNode); //throw X
+    void comparePairsReady(); //throw X
+
+    //create comparison result table and fill category except for files existing on both sides: undefinedFiles and undefinedSymlinks are appended!
     std::shared_ptr<BaseFolderPair> performComparison(const ResolvedFolderPair& fp,
                                                       const FolderPairCfg& fpCfg,
                                                       std::vector<FilePair*>& undefinedFiles,
                                                       std::vector<SymlinkPair*>& undefinedSymlinks) const;
 
-    std::map<DirectoryKey, DirectoryValue> folderBuffer_; //contains entries for *all* scanned folders!
+    void categorizeByTimeSize(const std::vector<FilePair*>& uncategorizedFiles, const std::vector<SymlinkPair*>& uncategorizedLinks, const FolderPairCfg& fpConfig) const;
+    void categorizeBySize    (const std::vector<FilePair*>& uncategorizedFiles, const std::vector<SymlinkPair*>& uncategorizedLinks) const;
+    RingBuffer<FilePair*> prepareContentComparison(const std::vector<FilePair*>& undefinedFiles, const std::vector<SymlinkPair*>& uncategorizedLinks) const;
+
+    const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad_;
+    std::vector<std::shared_ptr<BaseFolderPair>> output_; //same order as workLoad_; nullptr: not yet compared
+    std::vector<RingBuffer<FilePair*>> filesToCompareBytewise_; //same order as workLoad_
+
+    std::map<DirectoryKey, DirectoryValue> folderBuffer_; //folders read completely and still needed for comparison
+    std::map<DirectoryKey, size_t> folderUsage_; //number of folder pair sides not yet compared
+    const std::map<DirectoryKey, IncrementalRead>& incrementalReads_;
+    const std::map<AfsDevice, size_t>& deviceParallelOps_;
     const int fileTimeTolerance_;
     const FolderStatus& folderStatus_;
     ProcessCallback& cb_;
 };
 
 
-ComparisonBuffer::ComparisonBuffer(const std::set<DirectoryKey>& folderKeys,
+ComparisonBuffer::ComparisonBuffer(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad,
                                    const FolderStatus& folderStatus,
+                                   const std::map<DirectoryKey, IncrementalRead>& incrementalReads,
+                                   const std::map<AfsDevice, size_t>& deviceParallelOps,
                                    int fileTimeTolerance,
                                    ProcessCallback& callback) :
+    workLoad_(workLoad),
+    output_(workLoad.size()),
+    filesToCompareBytewise_(workLoad.size()),
+    incrementalReads_(incrementalReads),
+    deviceParallelOps_(deviceParallelOps),
     fileTimeTolerance_(fileTimeTolerance),
     folderStatus_(folderStatus),
     cb_(callback)
 {
     std::set<DirectoryKey> foldersToRead;
-    for (const DirectoryKey& folderKey : folderKeys)
-        if (folderStatus.existing.contains(folderKey.folderPath))
-            foldersToRead.insert(folderKey); //only traverse *existing* folders
+    for (const auto& [folderPair, fpCfg] : workLoad)
+        for (const AbstractPath& folderPath : {folderPair.folderPathLeft, folderPair.folderPathRight})
+        {
+            const DirectoryKey folderKey = getDirectoryKey(folderPath, fpCfg);
+            ++folderUsage_[folderKey];
+
+            if (folderStatus.existing.contains(folderPath))
+                foldersToRead.insert(folderKey); //only traverse *existing* folders
+        }
+
+    //create entries for the folders not traversed:
+    for (const auto& [folderKey, usage] : folderUsage_)
+        if (!foldersToRead.contains(folderKey))
+        {
+            if (auto it = folderStatus_.failedChecks.find(folderKey.folderPath);
+                it != folderStatus_.failedChecks.end())
+                //make sure all items are disabled => avoid user panicking: https://freefilesync.org/forum/viewtopic.php?t=7582
+                folderBuffer_[folderKey].failedFolderReads[Zstring() /*empty string for root*/] = utfTo<Zstringc>(it->second.toString());
+            else
+            {
+                folderBuffer_[folderKey];
+                assert(folderStatus_.notExisting.contains(folderKey.folderPath) ||
+                       AFS::isNullPath(folderKey.folderPath));
+            }
+        }
+    comparePairsReady(); //throw X
 
     //------------------------------------------------------------------
     const std::chrono::steady_clock::time_point compareStartTime = std::chrono::steady_clock::now();
@@ -206,30 +563,81 @@ ComparisonBuffer::ComparisonBuffer(const std::set<DirectoryKey>& folderKeys,
         callback.updateStatus(textScanning + statusLine); //throw X
     };
 
-    folderBuffer_ = parallelDeviceTraversal(foldersToRead,
+    std::map<DirectoryKey, std::vector<SubFolderRead>> subFolderReads;
+    for (const auto& [folderKey, incRead] : incrementalReads)
+        subFolderReads.emplace(folderKey, incRead.folderReads);
+
+    [[maybe_unused]] const std::map<DirectoryKey, DirectoryValue> foldersRemaining = parallelDeviceTraversal(foldersToRead, subFolderReads, deviceParallelOps,
+    [&](std::map<DirectoryKey, DirectoryValue>::node_type&& folderNode) { onFolderRead(std::move(folderNode)); }, //throw X
     [&](const PhaseCallback::ErrorInfo& errorInfo) { return callback.reportError(errorInfo); }, //throw X
     onStatusUpdate, //throw X
     UI_UPDATE_INTERVAL / 2); //every ~50 ms
+    assert(foldersRemaining.empty());
+    assert(std::all_of(output_.begin(), output_.end(), [](const std::shared_ptr<BaseFolderPair>& baseFolder) { return baseFolder; }));
 
     const int64_t totalTimeSec = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - compareStartTime).count();
 
     callback.logInfo(_("Comparison finished:") + L' ' +
                      _P("1 item found", "%x items found", itemsReported) + L" | " +
                      _("Time elapsed:") + L' ' + copyStringTo<std::wstring>(wxTimeSpan::Seconds(totalTimeSec).Format())); //throw X
-    //------------------------------------------------------------------
+}
 
-    //folderStatus_.existing already in buffer, now create entries for the rest:
-    for (const DirectoryKey& folderKey : folderKeys)
-        if (auto it = folderStatus_.failedChecks.find(folderKey.folderPath);
-            it != folderStatus_.failedChecks.end())
-            //make sure all items are disabled => avoid user panicking: https://freefilesync.org/forum/viewtopic.php?t=7582
-            folderBuffer_[folderKey].failedFolderReads[Zstring() /*empty string for root*/] = utfTo<Zstringc>(it->second.toString());
-        else
+
+void ComparisonBuffer::onFolderRead(std::map<DirectoryKey, DirectoryValue>::node_type&& folderNode) //throw X
+{
+    const DirectoryKey& folderKey = folderNode.key();
+    DirectoryValue&     folderVal = folderNode.mapped();
+
+    for (const Zstring& relPath : folderVal.scanCacheMismatches)
+        cb_.logInfo(replaceCpy(_("Scan cache: Folder %x was changed without updating its modification time."), L"%x",
+                               fmtPath(AFS::getDisplayPath(AFS::appendRelPath(folderKey.folderPath, relPath))))); //throw X
+
+    if (auto it = incrementalReads_.find(folderKey);
+        it != incrementalReads_.end() && !folderVal.failedFolderReads.contains(Zstring())) //base folder read failed => don't hide error behind sync.ffs_db
+        addLastSyncState(folderVal.folderCont, it->second, folderKey.filter.ref(), folderKey.handleSymlinks);
+
+    folderBuffer_.insert(std::move(folderNode));
+
+    comparePairsReady(); //throw X
+}
+
+
+void ComparisonBuffer::comparePairsReady() //throw X
+{
+    for (size_t i = 0; i < workLoad_.size(); ++i)
+        if (!output_[i])
         {
-            folderBuffer_[folderKey];
-            assert(folderStatus_.existing   .contains(folderKey.folderPath) ||
-                   folderStatus_.notExisting.contains(folderKey.folderPath) ||
-                   AFS::isNullPath(folderKey.folderPath));
+            const auto& [folderPair, fpCfg] = workLoad_[i];
+            const DirectoryKey folderKeyL = getDirectoryKey(folderPair.folderPathLeft,  fpCfg);
+            const DirectoryKey folderKeyR = getDirectoryKey(folderPair.folderPathRight, fpCfg);
+
+            if (folderBuffer_.contains(folderKeyL) &&
+                folderBuffer_.contains(folderKeyR))
+            {
+                //do basis scan and retrieve files existing on both sides as "compareCandidates"
+                std::vector<FilePair*> uncategorizedFiles;
+                std::vector<SymlinkPair*> uncategorizedLinks;
+                output_[i] = performComparison(folderPair, fpCfg, uncategorizedFiles, uncategorizedLinks);
+
+                switch (fpCfg.compareVar)
+                {
+                    case CompareVariant::timeSize:
+                        categorizeByTimeSize(uncategorizedFiles, uncategorizedLinks, fpCfg);
+                        break;
+                    case CompareVariant::size:
+                        categorizeBySize(uncategorizedFiles, uncategorizedLinks);
+                        break;
+                    case CompareVariant::content:
+                    case CompareVariant::hash:
+                        filesToCompareBytewise_[i] = prepareContentComparison(uncategorizedFiles, uncategorizedLinks);
+                        break;
+                }
+
+                //raw folder content is not needed anymore
+                for (const DirectoryKey& folderKey : {folderKeyL, folderKeyR})
+                    if (--folderUsage_[folderKey] == 0)
+                        folderBuffer_.erase(folderKey);
+            }
         }
 }
 
@@ -329,13 +737,8 @@ void categorizeSymlinkByTime(SymlinkPair& symlink)
 }
 
 
-std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareByTimeSize(const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const
+void ComparisonBuffer::categorizeByTimeSize(const std::vector<FilePair*>& uncategorizedFiles, const std::vector<SymlinkPair*>& uncategorizedLinks, const FolderPairCfg& fpConfig) const
 {
-    //do basis scan and retrieve files existing on both sides as "compareCandidates"
-    std::vector<FilePair*> uncategorizedFiles;
-    std::vector<SymlinkPair*> uncategorizedLinks;
-    std::shared_ptr<BaseFolderPair> output = performComparison(fp, fpConfig, uncategorizedFiles, uncategorizedLinks);
-
     //finish symlink categorization
     for (SymlinkPair* symlink : uncategorizedLinks)
         categorizeSymlinkByTime(*symlink);
@@ -380,7 +783,6 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareByTimeSize(const Resolv
                 break;
         }
     }
-    return output;
 }
 
 
@@ -425,13 +827,8 @@ void categorizeSymlinkByContent(SymlinkPair& symlink, PhaseCallback& callback)
 }
 
 
-std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareBySize(const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const
+void ComparisonBuffer::categorizeBySize(const std::vector<FilePair*>& uncategorizedFiles, const std::vector<SymlinkPair*>& uncategorizedLinks) const
 {
-    //do basis scan and retrieve files existing on both sides as "compareCandidates"
-    std::vector<FilePair*> uncategorizedFiles;
-    std::vector<SymlinkPair*> uncategorizedLinks;
-    std::shared_ptr<BaseFolderPair> output = performComparison(fp, fpConfig, uncategorizedFiles, uncategorizedLinks);
-
     //finish symlink categorization
     for (SymlinkPair* symlink : uncategorizedLinks)
         categorizeSymlinkByContent(*symlink, cb_); //"compare by size" has the semantics of a quick content-comparison!
@@ -455,7 +852,6 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareBySize(const ResolvedFo
         else
             file->setCategory<FILE_DIFFERENT_CONTENT>();
     }
-    return output;
 }
 
 
@@ -467,18 +863,73 @@ namespace parallel
 inline
 bool filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, //throw FileError, X
                           const IoCallback& notifyUnbufferedIO /*throw X*/,
+                          ContentHash* contentHash,
                           std::mutex& singleThread)
-{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
+{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, notifyUnbufferedIO, contentHash); /*throw FileError, X*/ }, singleThread); }
+
+inline
+ContentHash getContentHash(const AbstractPath& filePath, const IoCallback& notifyUnbufferedIO /*throw X*/, std::mutex& singleThread) //throw FileError, X
+{ return parallelScope([=] { return getContentHash(filePath, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
 }
 
 
 namespace
 {
-void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingContentOfFiles, AsyncCallback& acb, std::mutex& singleThread) //throw ThreadStopRequest
+struct ContentCheck
+{
+    FilePair* file = nullptr;
+    const ContentHash* dbHashL = nullptr; //optional: side unchanged since last sync => content is known from sync.ffs_db
+    const ContentHash* dbHashR = nullptr; //
+    bool needHash = false; //content hash of equal files is saved to sync.ffs_db
+};
+
+
+//CompareVariant::hash: both sides are hashed independently => categorize as soon as both hashes are known
+struct SideHashes
+{
+    FilePair* file = nullptr;
+    std::optional<ContentHash> hashL;
+    std::optional<ContentHash> hashR;
+    std::wstring errorMsg;
+    int sidesPending = 0;
+    bool needHash = false; //content hash of equal files is saved to sync.ffs_db
+};
+
+struct HashTask
+{
+    SideHashes* sideHashes = nullptr;
+    SelectSide side = SelectSide::left;
+};
+
+using BinaryTask = std::variant<ContentCheck, HashTask>;
+
+
+void setCategoryContentEqual(FilePair& file)
+{
+    //Caveat:
+    //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
+    //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
+    //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
+    if (getUnicodeNormalForm(file.getItemName<SelectSide::left >()) !=
+        getUnicodeNormalForm(file.getItemName<SelectSide::right>()))
+        file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
+#if 0 //don't synchronize modtime only see FolderPairSyncer::synchronizeFileInt(), SO_COPY_METADATA_TO_*
+    else if (!sameFileTime(file.getLastWriteTime<SelectSide::left>(),
+                           file.getLastWriteTime<SelectSide::right>(), file.base().getFileTimeTolerance(), file.base().getIgnoredTimeShift()))
+        file.setCategoryDiffMetadata(getDescrDiffMetaData(file));
+#endif
+    else
+        file.setCategory<FILE_EQUAL>();
+}
+
+
+void categorizeFileByContent(const ContentCheck& check, const std::wstring& txtComparingContentOfFiles, AsyncCallback& acb, std::mutex& singleThread) //throw ThreadStopRequest
 {
+    FilePair& file = *check.file;
     acb.updateStatus(replaceCpy(txtComparingContentOfFiles, L"%x", fmtPath(file.getRelativePathAny()))); //throw ThreadStopRequest
 
     bool haveSameContent = false;
+    std::optional<ContentHash> contentHash;
     const std::wstring errMsg = tryReportingError([&]
     {
         AsyncItemStatReporter statReporter(1, file.getFileSize<SelectSide::left>(), acb);
@@ -490,8 +941,23 @@ void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingCon
             interruptionPoint(); //throw ThreadStopRequest
         };
 
-        haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath<SelectSide::left >(),
-                                                         file.getAbstractPath<SelectSide::right>(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadStopRequest
+        if (check.dbHashL || check.dbHashR) //only one side changed since last sync: no need to read the other one
+        {
+            assert(!check.dbHashL || !check.dbHashR);
+            contentHash = parallel::getContentHash(check.dbHashL ?
+                                                   file.getAbstractPath<SelectSide::right>() :
+                                                   file.getAbstractPath<SelectSide::left >(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadStopRequest
+            haveSameContent = *contentHash == (check.dbHashL ? *check.dbHashL : *check.dbHashR);
+        }
+        else
+        {
+            ContentHash hashTmp{};
+            haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath<SelectSide::left >(),
+                                                             file.getAbstractPath<SelectSide::right>(), notifyUnbufferedIO,
+                                                             check.needHash ? &hashTmp : nullptr, singleThread); //throw FileError, ThreadStopRequest
+            if (check.needHash)
+                contentHash = hashTmp;
+        }
         statReporter.reportDelta(1, 0);
     }, acb); //throw ThreadStopRequest
 
@@ -501,100 +967,274 @@ void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingCon
     {
         if (haveSameContent)
         {
-            //Caveat:
-            //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
-            //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
-            //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
-            if (getUnicodeNormalForm(file.getItemName<SelectSide::left >()) !=
-                getUnicodeNormalForm(file.getItemName<SelectSide::right>()))
-                file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
-#if 0 //don't synchronize modtime only see FolderPairSyncer::synchronizeFileInt(), SO_COPY_METADATA_TO_*
-            else if (!sameFileTime(file.getLastWriteTime<SelectSide::left>(),
-                                   file.getLastWriteTime<SelectSide::right>(), file.base().getFileTimeTolerance(), file.base().getIgnoredTimeShift()))
-                file.setCategoryDiffMetadata(getDescrDiffMetaData(file));
-#endif
-            else
-                file.setCategory<FILE_EQUAL>();
+            setCategoryContentEqual(file);
+
+            if (contentHash)
+                file.base().setContentHash(file, *contentHash);
+        }
+        else
+            file.setCategory<FILE_DIFFERENT_CONTENT>();
+    }
+}
+
+
+void categorizeFileByContent(const HashTask& task, const std::wstring& txtComparingContentOfFiles, AsyncCallback& acb, std::mutex& singleThread) //throw ThreadStopRequest
+{
+    SideHashes& sideHashes = *task.sideHashes;
+    FilePair& file = *sideHashes.file;
+    acb.updateStatus(replaceCpy(txtComparingContentOfFiles, L"%x", fmtPath(file.getRelativePathAny()))); //throw ThreadStopRequest
+
+    std::optional<ContentHash> contentHash;
+    const std::wstring errMsg = tryReportingError([&]
+    {
+        AsyncItemStatReporter statReporter(0, file.getFileSize<SelectSide::left>(), acb); //item is reported after *both* sides are hashed
+
+        //callbacks run *outside* singleThread_ lock! => fine
+        auto notifyUnbufferedIO = [&statReporter](int64_t bytesDelta)
+        {
+            statReporter.reportDelta(0, bytesDelta);
+            interruptionPoint(); //throw ThreadStopRequest
+        };
+
+        contentHash = parallel::getContentHash(task.side == SelectSide::left ?
+                                               file.getAbstractPath<SelectSide::left >() :
+                                               file.getAbstractPath<SelectSide::right>(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadStopRequest
+    }, acb); //throw ThreadStopRequest
+
+    (task.side == SelectSide::left ? sideHashes.hashL : sideHashes.hashR) = contentHash;
+    if (sideHashes.errorMsg.empty())
+        sideHashes.errorMsg = errMsg;
+
+    assert(sideHashes.sidesPending > 0);
+    if (--sideHashes.sidesPending == 0)
+    {
+        if (!sideHashes.errorMsg.empty())
+            file.setCategoryConflict(utfTo<Zstringc>(sideHashes.errorMsg));
+        else if (*sideHashes.hashL == *sideHashes.hashR)
+        {
+            setCategoryContentEqual(file);
+
+            if (sideHashes.needHash)
+                file.base().setContentHash(file, *sideHashes.hashL);
         }
         else
             file.setCategory<FILE_DIFFERENT_CONTENT>();
+
+        acb.updateDataProcessed(1, 0); //noexcept
     }
 }
+
+
+const InSyncFolder* findDbFolder(const ContainerObject& folder, const InSyncFolder& dbBaseFolder, std::unordered_map<const ContainerObject*, const InSyncFolder*>& dbFolderCache)
+{
+    if (auto it = dbFolderCache.find(&folder);
+        it != dbFolderCache.end())
+        return it->second;
+
+    const InSyncFolder* dbFolder = &dbBaseFolder;
+    if (const auto folderPair = dynamic_cast<const FolderPair*>(&folder))
+    {
+        dbFolder = nullptr;
+        if (const InSyncFolder* dbParent = findDbFolder(folderPair->parent(), dbBaseFolder, dbFolderCache))
+            if (auto it = dbParent->folders.find(folderPair->getItemName<SelectSide::left>());
+                it != dbParent->folders.end())
+                dbFolder = &it->second;
+    }
+    dbFolderCache.emplace(&folder, dbFolder);
+    return dbFolder;
+}
+
+
+//unlike matchesDbEntry() in algorithm.cpp we're not looking for *visual* changes: the file must be *exactly* as seen during last sync
+template <SelectSide side>
+bool unchangedSinceLastSync(const FilePair& file, const InSyncFile& dbFile)
+{
+    const InSyncDescrFile& descrDb = SelectParam<side>::ref(dbFile.left, dbFile.right);
+
+    return file.getFileSize     <side>() == dbFile.fileSize &&
+           file.getLastWriteTime<side>() == descrDb.modTime &&
+           file.getFilePrint    <side>() == descrDb.filePrint;
+}
+}
+
+
+RingBuffer<FilePair*> ComparisonBuffer::prepareContentComparison(const std::vector<FilePair*>& undefinedFiles, const std::vector<SymlinkPair*>& uncategorizedLinks) const
+{
+    const Zstringc txtConflictSkippedBinaryComparison = getConflictSkippedBinaryComparison(); //avoid premature pess.: save memory via ref-counted string
+
+    RingBuffer<FilePair*> filesToCompareBytewise;
+    //content comparison of file content happens AFTER finding corresponding files and AFTER filtering
+    //in order to separate into two processes (scanning and comparing)
+    for (FilePair* file : undefinedFiles)
+        //pre-check: files have different content if they have a different file size (must not be FILE_EQUAL: see InSyncFile)
+        if (file->getFileSize<SelectSide::left>() != file->getFileSize<SelectSide::right>())
+            file->setCategory<FILE_DIFFERENT_CONTENT>();
+        else
+        {
+            //perf: skip binary comparison for excluded rows (e.g. via time span and size filter)!
+            //both soft and hard filter were already applied in ComparisonBuffer::performComparison()!
+            if (!file->isActive())
+                file->setCategoryConflict(txtConflictSkippedBinaryComparison);
+            else
+                filesToCompareBytewise.push_back(file);
+        }
+
+    //finish symlink categorization
+    for (SymlinkPair* symlink : uncategorizedLinks)
+        categorizeSymlinkByContent(*symlink, cb_);
+
+    return filesToCompareBytewise;
 }
 
 
-std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad) const
+FolderComparison ComparisonBuffer::finishComparison(std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>>& lastSyncStates) //throw X
 {
     struct ParallelOps
     {
-        size_t current      = 0;
+        size_t current = 0;
+        size_t max     = 1;
     };
     std::map<AfsDevice, ParallelOps> parallelOpsStatus;
 
+    auto getParallelOps = [&](const AfsDevice& afsDevice) -> ParallelOps&
+    {
+        auto it = parallelOpsStatus.find(afsDevice);
+        if (it == parallelOpsStatus.end())
+            it = parallelOpsStatus.emplace(afsDevice, ParallelOps{0, getDeviceParallelOps(deviceParallelOps_, afsDevice)}).first;
+        return it->second;
+    };
+
     struct BinaryWorkload
     {
         ParallelOps& parallelOpsL; //
         ParallelOps& parallelOpsR; //consider aliasing!
-        RingBuffer<FilePair*> filesToCompareBytewise;
+        RingBuffer<BinaryTask> filesToCompareBytewise;
     };
     std::vector<BinaryWorkload> fpWorkload;
+    std::deque<SideHashes> sideHashesBuf; //CompareVariant::hash; stable references!
 
-    auto addToBinaryWorkload = [&](const AbstractPath& basePathL, const AbstractPath& basePathR, RingBuffer<FilePair*>&& filesToCompareBytewise)
+    auto addToBinaryWorkload = [&](const AbstractPath& basePathL, const AbstractPath& basePathR, RingBuffer<BinaryTask>&& filesToCompareBytewise)
     {
-        ParallelOps& posL = parallelOpsStatus[basePathL.afsDevice];
-        ParallelOps& posR = parallelOpsStatus[basePathR.afsDevice];
+        ParallelOps& posL = getParallelOps(basePathL.afsDevice);
+        ParallelOps& posR = getParallelOps(basePathR.afsDevice);
         fpWorkload.push_back({posL, posR, std::move(filesToCompareBytewise)});
     };
 
-    //PERF_START;
-    std::list<std::shared_ptr<BaseFolderPair>> output;
+    auto usesSyncDatabase = [](const FolderPairCfg& fpCfg)
+    {
+        return fpCfg.directionCfg.var == SyncVariant::twoWay || detectMovedFilesEnabled(fpCfg.directionCfg); //=> sync.ffs_db is kept up to date
+    };
 
-    const Zstringc txtConflictSkippedBinaryComparison = getConflictSkippedBinaryComparison(); //avoid premature pess.: save memory via ref-counted string
+    //sync.ffs_db already loaded for incremental comparison: same folder pair => same content
+    for (size_t i = 0; i < workLoad_.size(); ++i)
+        for (const AbstractPath& folderPath : {workLoad_[i].first.folderPathLeft, workLoad_[i].first.folderPathRight})
+            if (auto it = incrementalReads_.find(getDirectoryKey(folderPath, workLoad_[i].second));
+                it != incrementalReads_.end())
+                lastSyncStates.emplace(output_[i].get(), it->second.lastSyncState);
 
-    for (const auto& [folderPair, fpCfg] : workLoad)
-    {
-        std::vector<FilePair*> undefinedFiles;
-        std::vector<SymlinkPair*> uncategorizedLinks;
-        //run basis scan and retrieve candidates for binary comparison (files existing on both sides)
-        output.push_back(performComparison(folderPair, fpCfg, undefinedFiles, uncategorizedLinks));
-
-        RingBuffer<FilePair*> filesToCompareBytewise;
-        //content comparison of file content happens AFTER finding corresponding files and AFTER filtering
-        //in order to separate into two processes (scanning and comparing)
-        for (FilePair* file : undefinedFiles)
-            //pre-check: files have different content if they have a different file size (must not be FILE_EQUAL: see InSyncFile)
-            if (file->getFileSize<SelectSide::left>() != file->getFileSize<SelectSide::right>())
-                file->setCategory<FILE_DIFFERENT_CONTENT>();
-            else
+    //files unchanged since last sync don't need to be read again: load sync.ffs_db *after* scanning => folderBuffer_ is already freed
+    std::vector<const BaseFolderPair*> baseFoldersForDbLoad;
+    for (size_t i = 0; i < workLoad_.size(); ++i)
+        if (!filesToCompareBytewise_[i].empty() && usesSyncDatabase(workLoad_[i].second) && !lastSyncStates.contains(output_[i].get()))
+            baseFoldersForDbLoad.push_back(output_[i].get());
+
+    //keep alive until comparison is done: ContentCheck references hashes
+    if (!baseFoldersForDbLoad.empty())
+        lastSyncStates.merge(loadLastSynchronousState(baseFoldersForDbLoad, cb_)); //throw X
+
+    //PERF_START;
+    //candidates for binary comparison were collected while traversing: see comparePairsReady()
+    for (size_t i = 0; i < workLoad_.size(); ++i)
+        if (!filesToCompareBytewise_[i].empty())
+        {
+            BaseFolderPair& baseFolder = *output_[i];
+            const bool needHash = usesSyncDatabase(workLoad_[i].second);
+            const bool hashSides = workLoad_[i].second.compareVar == CompareVariant::hash;
+
+            auto itDb = lastSyncStates.find(&baseFolder);
+            const InSyncFolder* dbBaseFolder = itDb != lastSyncStates.end() ? &itDb->second.ref() : nullptr;
+            std::unordered_map<const ContainerObject*, const InSyncFolder*> dbFolderCache;
+
+            RingBuffer<BinaryTask> filesToCompareBytewise;
+            RingBuffer<BinaryTask> filesToHashL; //CompareVariant::hash: read each side at its own device's pace
+            RingBuffer<BinaryTask> filesToHashR; //
+            for (FilePair* file : filesToCompareBytewise_[i])
             {
-                //perf: skip binary comparison for excluded rows (e.g. via time span and size filter)!
-                //both soft and hard filter were already applied in ComparisonBuffer::performComparison()!
-                if (!file->isActive())
-                    file->setCategoryConflict(txtConflictSkippedBinaryComparison);
+                const ContentHash* dbHashL = nullptr; //side unchanged since last sync => content is known from sync.ffs_db
+                const ContentHash* dbHashR = nullptr; //
+
+                if (dbBaseFolder)
+                    if (const InSyncFolder* dbFolder = findDbFolder(file->parent(), *dbBaseFolder, dbFolderCache))
+                        if (auto itFile = dbFolder->files.find(file->getItemName<SelectSide::left>());
+                            itFile != dbFolder->files.end() && (itFile->second.cmpVar == CompareVariant::content ||
+                                                                itFile->second.cmpVar == CompareVariant::hash))
+                        {
+                            const InSyncFile& dbFile = itFile->second;
+                            const bool unchangedL = unchangedSinceLastSync<SelectSide::left >(*file, dbFile);
+                            const bool unchangedR = unchangedSinceLastSync<SelectSide::right>(*file, dbFile);
+
+                            if (unchangedL && unchangedR)
+                            {
+                                setCategoryContentEqual(*file);
+                                if (dbFile.contentHash)
+                                    baseFolder.setContentHash(*file, *dbFile.contentHash);
+                                continue;
+                            }
+                            if (dbFile.contentHash)
+                            {
+                                if (unchangedL) dbHashL = &*dbFile.contentHash;
+                                if (unchangedR) dbHashR = &*dbFile.contentHash;
+                            }
+                        }
+
+                if (hashSides)
+                {
+                    SideHashes& sideHashes = sideHashesBuf.emplace_back();
+                    sideHashes.file = file;
+                    sideHashes.needHash = needHash;
+
+                    if (dbHashL)
+                        sideHashes.hashL = *dbHashL;
+                    else
+                    {
+                        filesToHashL.push_back(HashTask{&sideHashes, SelectSide::left});
+                        ++sideHashes.sidesPending;
+                    }
+                    if (dbHashR)
+                        sideHashes.hashR = *dbHashR;
+                    else
+                    {
+                        filesToHashR.push_back(HashTask{&sideHashes, SelectSide::right});
+                        ++sideHashes.sidesPending;
+                    }
+                }
                 else
-                    filesToCompareBytewise.push_back(file);
+                    filesToCompareBytewise.push_back(ContentCheck{file, dbHashL, dbHashR, needHash});
             }
-        if (!filesToCompareBytewise.empty())
-            addToBinaryWorkload(output.back()->getAbstractPath<SelectSide::left >(),
-                                output.back()->getAbstractPath<SelectSide::right>(), std::move(filesToCompareBytewise));
+            filesToCompareBytewise_[i].clear();
 
-        //finish symlink categorization
-        for (SymlinkPair* symlink : uncategorizedLinks)
-            categorizeSymlinkByContent(*symlink, cb_);
-    }
+            const AbstractPath basePathL = baseFolder.getAbstractPath<SelectSide::left >();
+            const AbstractPath basePathR = baseFolder.getAbstractPath<SelectSide::right>();
+
+            if (!filesToCompareBytewise.empty()) addToBinaryWorkload(basePathL, basePathR, std::move(filesToCompareBytewise));
+            if (!filesToHashL          .empty()) addToBinaryWorkload(basePathL, basePathL, std::move(filesToHashL));
+            if (!filesToHashR          .empty()) addToBinaryWorkload(basePathR, basePathR, std::move(filesToHashR));
+        }
 
     //finish categorization: compare files (that have same size) bytewise...
     if (!fpWorkload.empty()) //run ProcessPhase::comparingContent only when needed
     {
-        int      itemsTotal = 0;
+        int      itemsTotal = static_cast<int>(sideHashesBuf.size());
         uint64_t bytesTotal = 0;
         for (const BinaryWorkload& bwl : fpWorkload)
-        {
-            itemsTotal += bwl.filesToCompareBytewise.size();
-
-            for (const FilePair* file : bwl.filesToCompareBytewise)
-                bytesTotal += file->getFileSize<SelectSide::left>(); //left and right file sizes are equal
-        }
+            for (const BinaryTask& task : bwl.filesToCompareBytewise)
+                if (const ContentCheck* check = std::get_if<ContentCheck>(&task))
+                {
+                    ++itemsTotal;
+                    bytesTotal += check->file->getFileSize<SelectSide::left>(); //left and right file sizes are equal
+                }
+                else
+                    bytesTotal += std::get<HashTask>(task).sideHashes->file->getFileSize<SelectSide::left>();
         cb_.initNewPhase(itemsTotal, bytesTotal, ProcessPhase::comparingContent); //throw X
 
         //PERF_START;
@@ -616,14 +1256,14 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
                 BinaryWorkload& bwl = fpWorkload[j];
                 ParallelOps& posL = bwl.parallelOpsL;
                 ParallelOps& posR = bwl.parallelOpsR;
-                const size_t newTaskCount = std::min<size_t>({1                 - posL.current, 1                 - posR.current, bwl.filesToCompareBytewise.size()});
+                const size_t newTaskCount = std::min<size_t>({posL.max - posL.current, posR.max - posR.current, bwl.filesToCompareBytewise.size()});
                 if (&posL != &posR)
                     posL.current += newTaskCount; //
                 posR.current += newTaskCount;     //consider aliasing!
 
                 for (size_t i = 0; i < newTaskCount; ++i)
                 {
-                    tg.run([&, statusPrio = j, &file = *bwl.filesToCompareBytewise.front()]
+                    tg.run([&, statusPrio = j, task = bwl.filesToCompareBytewise.front()]
                     {
                         acb.notifyTaskBegin(statusPrio); //prioritize status messages according to natural order of folder pairs
                         ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
@@ -634,7 +1274,7 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
                                              /**/                --posR.current;
                                              scheduleMoreTasks());
 
-                        categorizeFileByContent(file, txtComparingContentOfFiles, acb, singleThread); //throw ThreadStopRequest
+                        std::visit([&](const auto& task2) { categorizeFileByContent(task2, txtComparingContentOfFiles, acb, singleThread); }, task); //throw ThreadStopRequest
                     });
 
                     bwl.filesToCompareBytewise.pop_front();
@@ -654,7 +1294,7 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
         acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, cb_); //throw X
     }
 
-    return output;
+    return FolderComparison(output_.begin(), output_.end());
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -663,9 +1303,11 @@ class MergeSides
 {
 public:
     MergeSides(const std::map<ZstringNoCase, Zstringc>& errorsByRelPath,
+               const SoftFilter* pruneFilter, //optional: drop items excluded on both sides
                std::vector<FilePair*>& undefinedFilesOut,
                std::vector<SymlinkPair*>& undefinedSymlinksOut) :
         errorsByRelPath_(errorsByRelPath),
+        pruneFilter_(pruneFilter),
         undefinedFiles_(undefinedFilesOut),
         undefinedSymlinks_(undefinedSymlinksOut) {}
 
@@ -686,7 +1328,28 @@ private:
 
     const Zstringc* checkFailedRead(FileSystemObject& fsObj, const Zstringc* errorMsg);
 
+    //same result as ApplySoftFilter (algorithm.cpp) for items existing on both sides; read errors must stay visible on GUI
+    bool canPrune(const ContainerObject& parent, const Zstring& itemName, const FileAttributes& attrL, const FileAttributes& attrR, const Zstringc* errorMsg) const
+    {
+        return pruneFilter_ && !errorMsg &&
+               !(pruneFilter_->matchSize(attrL.fileSize) && pruneFilter_->matchTime(attrL.modTime)) &&
+               !(pruneFilter_->matchSize(attrR.fileSize) && pruneFilter_->matchTime(attrR.modTime)) &&
+               !hasFailedRead(parent, itemName);
+    }
+    bool canPrune(const ContainerObject& parent, const Zstring& itemName, const LinkAttributes& attrL, const LinkAttributes& attrR, const Zstringc* errorMsg) const
+    {
+        return pruneFilter_ && !errorMsg &&
+               !pruneFilter_->matchTime(attrL.modTime) &&
+               !pruneFilter_->matchTime(attrR.modTime) &&
+               !hasFailedRead(parent, itemName);
+    }
+    bool hasFailedRead(const ContainerObject& parent, const Zstring& itemName) const
+    {
+        return !errorsByRelPath_.empty() && errorsByRelPath_.contains(nativeAppendPaths(parent.getRelativePathAny(), itemName));
+    }
+
     const std::map<ZstringNoCase, Zstringc>& errorsByRelPath_; //base-relative paths or empty if read-error for whole base directory
+    const SoftFilter* const pruneFilter_;
     std::vector<FilePair*>&    undefinedFiles_;
     std::vector<SymlinkPair*>& undefinedSymlinks_;
 };
@@ -713,41 +1376,42 @@ const Zstringc* MergeSides::checkFailedRead(FileSystemObject& fsObj, const Zstri
 template <SelectSide side>
 void MergeSides::fillOneSide(const FolderContainer& folderCont, const Zstringc* errorMsg, ContainerObject& output)
 {
-    for (const auto& [fileName, attrib] : folderCont.files)
+    for (const auto& file : folderCont.files)
     {
-        FilePair& newItem = output.addSubFile<side>(fileName, attrib);
+        FilePair& newItem = output.addSubFile<side>(file.itemName, file.value);
         checkFailedRead(newItem, errorMsg);
     }
 
-    for (const auto& [linkName, attrib] : folderCont.symlinks)
+    for (const auto& symlink : folderCont.symlinks)
     {
-        SymlinkPair& newItem = output.addSubLink<side>(linkName, attrib);
+        SymlinkPair& newItem = output.addSubLink<side>(symlink.itemName, symlink.value);
         checkFailedRead(newItem, errorMsg);
     }
 
-    for (const auto& [folderName, attrAndSub] : folderCont.folders)
+    for (const auto& folder : folderCont.folders)
     {
-        FolderPair& newFolder = output.addSubFolder<side>(folderName, attrAndSub.first);
+        FolderPair& newFolder = output.addSubFolder<side>(folder.itemName, folder.value->attr);
         const Zstringc* errorMsgNew = checkFailedRead(newFolder, errorMsg);
-        fillOneSide<side>(attrAndSub.second, errorMsgNew, newFolder); //recurse
+        fillOneSide<side>(folder.value->cont, errorMsgNew, newFolder); //recurse
     }
 }
 
 
-template <class MapType, class ProcessLeftOnly, class ProcessRightOnly, class ProcessBoth> inline
-void matchFolders(const MapType& mapLeft, const MapType& mapRight, ProcessLeftOnly lo, ProcessRightOnly ro, ProcessBoth bo)
+template <class ItemList, class ProcessLeftOnly, class ProcessRightOnly, class ProcessBoth> inline
+void matchFolders(const ItemList& itemsLeft, const ItemList& itemsRight, ProcessLeftOnly lo, ProcessRightOnly ro, ProcessBoth bo)
 {
     struct FileRef
     {
-        Zstring upperCaseName; //buffer expensive getUpperCase() calls!!
-        const typename MapType::value_type* ref;
+        Zstring upperCaseName; //buffer expensive getUpperCase() calls!! short-lived: per folder only, shares itemName's buffer if already upper-case
+        const typename ItemList::value_type* ref;
         bool leftSide;
+        Zstring normalName; //ambiguous ranges only: buffer expensive getUnicodeNormalForm() calls!!
     };
     std::vector<FileRef> fileList;
-    fileList.reserve(mapLeft.size() + mapRight.size()); //perf: ~5% shorter runtime
+    fileList.reserve(itemsLeft.size() + itemsRight.size()); //perf: ~5% shorter runtime
 
-    for (const auto& item : mapLeft ) fileList.push_back({getUpperCase(item.first), &item, true});
-    for (const auto& item : mapRight) fileList.push_back({getUpperCase(item.first), &item, false});
+    for (const auto& item : itemsLeft ) fileList.push_back({getUpperCase(item.itemName), &item, true});
+    for (const auto& item : itemsRight) fileList.push_back({getUpperCase(item.itemName), &item, false});
 
     //primary sort: ignore unicode normal form and case
     //bonus: natural default sequence on file guid UI
@@ -780,16 +1444,18 @@ void matchFolders(const MapType& mapLeft, const MapType& mapRight, ProcessLeftOn
         auto itEndEq = std::find_if(it + 1, fileList.end(), [&](const FileRef& fr) { return fr.upperCaseName != it->upperCaseName; });
         if (!tryMatchRange(it, itEndEq))
         {
+            std::for_each(it, itEndEq, [](FileRef& fr) { fr.normalName = getUnicodeNormalForm(fr.ref->itemName); });
+
             //secondary sort: respect case, ignore unicode normal forms
-            std::sort(it, itEndEq, [](const FileRef& lhs, const FileRef& rhs) { return getUnicodeNormalForm(lhs.ref->first) < getUnicodeNormalForm(rhs.ref->first); });
+            std::sort(it, itEndEq, [](const FileRef& lhs, const FileRef& rhs) { return lhs.normalName < rhs.normalName; });
 
             for (auto itCase = it; itCase != itEndEq;)
             {
                 //find equal range: respect case, ignore Unicode normalization
-                auto itEndCase = std::find_if(itCase + 1, itEndEq, [&](const FileRef& fr) { return getUnicodeNormalForm(fr.ref->first) != getUnicodeNormalForm(itCase->ref->first); });
+                auto itEndCase = std::find_if(itCase + 1, itEndEq, [&](const FileRef& fr) { return fr.normalName != itCase->normalName; });
                 if (!tryMatchRange(itCase, itEndCase))
                 {
-                    const Zstringc& conflictMsg = getConflictAmbiguousItemName(itCase->ref->first);
+                    const Zstringc& conflictMsg = getConflictAmbiguousItemName(itCase->ref->itemName);
                     std::for_each(itCase, itEndCase, [&](const FileRef& fr)
                     {
                         if (fr.leftSide)
@@ -812,24 +1478,27 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
 
     matchFolders(lhs.files, rhs.files, [&](const FileData& fileLeft, const Zstringc* conflictMsg)
     {
-        FilePair& newItem = output.addSubFile<SelectSide::left >(fileLeft .first, fileLeft .second);
+        FilePair& newItem = output.addSubFile<SelectSide::left >(fileLeft .itemName, fileLeft .value);
         checkFailedRead(newItem, conflictMsg ? conflictMsg : errorMsg);
     },
     [&](const FileData& fileRight, const Zstringc* conflictMsg)
     {
-        FilePair& newItem = output.addSubFile<SelectSide::right>(fileRight.first, fileRight.second);
+        FilePair& newItem = output.addSubFile<SelectSide::right>(fileRight.itemName, fileRight.value);
         checkFailedRead(newItem, conflictMsg ? conflictMsg : errorMsg);
     },
     [&](const FileData& fileLeft, const FileData& fileRight)
     {
-        FilePair& newItem = output.addSubFile(fileLeft.first,
-                                              fileLeft.second,
+        if (canPrune(output, fileLeft.itemName, fileLeft.value, fileRight.value, errorMsg))
+            return;
+
+        FilePair& newItem = output.addSubFile(fileLeft.itemName,
+                                              fileLeft.value,
                                               FILE_CONFLICT, //dummy-value until categorization is finished later
-                                              fileRight.first,
-                                              fileRight.second);
+                                              fileRight.itemName,
+                                              fileRight.value);
         if (!checkFailedRead(newItem, errorMsg))
             undefinedFiles_.push_back(&newItem);
-        static_assert(std::is_same_v<ContainerObject::FileList, std::list<FilePair>>); //ContainerObject::addSubFile() must NOT invalidate references used in "undefinedFiles"!
+        static_assert(std::is_same_v<ContainerObject::FileList, zen::FixedBlockList<FilePair>>); //ContainerObject::addSubFile() must NOT invalidate references used in "undefinedFiles"!
     });
 
     //-----------------------------------------------------------------------------------------------
@@ -837,21 +1506,24 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
 
     matchFolders(lhs.symlinks, rhs.symlinks, [&](const SymlinkData& symlinkLeft, const Zstringc* conflictMsg)
     {
-        SymlinkPair& newItem = output.addSubLink<SelectSide::left >(symlinkLeft .first, symlinkLeft .second);
+        SymlinkPair& newItem = output.addSubLink<SelectSide::left >(symlinkLeft .itemName, symlinkLeft .value);
         checkFailedRead(newItem, conflictMsg ? conflictMsg : errorMsg);
     },
     [&](const SymlinkData& symlinkRight, const Zstringc* conflictMsg)
     {
-        SymlinkPair& newItem = output.addSubLink<SelectSide::right>(symlinkRight.first, symlinkRight.second);
+        SymlinkPair& newItem = output.addSubLink<SelectSide::right>(symlinkRight.itemName, symlinkRight.value);
         checkFailedRead(newItem, conflictMsg ? conflictMsg : errorMsg);
     },
     [&](const SymlinkData& symlinkLeft, const SymlinkData& symlinkRight) //both sides
     {
-        SymlinkPair& newItem = output.addSubLink(symlinkLeft.first,
-                                                 symlinkLeft.second,
+        if (canPrune(output, symlinkLeft.itemName, symlinkLeft.value, symlinkRight.value, errorMsg))
+            return;
+
+        SymlinkPair& newItem = output.addSubLink(symlinkLeft.itemName,
+                                                 symlinkLeft.value,
                                                  SYMLINK_CONFLICT, //dummy-value until categorization is finished later
-                                                 symlinkRight.first,
-                                                 symlinkRight.second);
+                                                 symlinkRight.itemName,
+                                                 symlinkRight.value);
         if (!checkFailedRead(newItem, errorMsg))
             undefinedSymlinks_.push_back(&newItem);
     });
@@ -861,27 +1533,27 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
 
     matchFolders(lhs.folders, rhs.folders, [&](const FolderData& dirLeft, const Zstringc* conflictMsg)
     {
-        FolderPair& newFolder = output.addSubFolder<SelectSide::left>(dirLeft.first, dirLeft.second.first);
+        FolderPair& newFolder = output.addSubFolder<SelectSide::left>(dirLeft.itemName, dirLeft.value->attr);
         const Zstringc* errorMsgNew = checkFailedRead(newFolder, conflictMsg ? conflictMsg : errorMsg);
-        this->fillOneSide<SelectSide::left>(dirLeft.second.second, errorMsgNew, newFolder); //recurse
+        this->fillOneSide<SelectSide::left>(dirLeft.value->cont, errorMsgNew, newFolder); //recurse
     },
     [&](const FolderData& dirRight, const Zstringc* conflictMsg)
     {
-        FolderPair& newFolder = output.addSubFolder<SelectSide::right>(dirRight.first, dirRight.second.first);
+        FolderPair& newFolder = output.addSubFolder<SelectSide::right>(dirRight.itemName, dirRight.value->attr);
         const Zstringc* errorMsgNew = checkFailedRead(newFolder, conflictMsg ? conflictMsg : errorMsg);
-        this->fillOneSide<SelectSide::right>(dirRight.second.second, errorMsgNew, newFolder); //recurse
+        this->fillOneSide<SelectSide::right>(dirRight.value->cont, errorMsgNew, newFolder); //recurse
     },
     [&](const FolderData& dirLeft, const FolderData& dirRight)
     {
-        FolderPair& newFolder = output.addSubFolder(dirLeft.first, dirLeft.second.first, DIR_EQUAL, dirRight.first, dirRight.second.first);
+        FolderPair& newFolder = output.addSubFolder(dirLeft.itemName, dirLeft.value->attr, DIR_EQUAL, dirRight.itemName, dirRight.value->attr);
         const Zstringc* errorMsgNew = checkFailedRead(newFolder, errorMsg);
 
         if (!errorMsgNew)
-            if (getUnicodeNormalForm(dirLeft.first) !=
-                getUnicodeNormalForm(dirRight.first))
+            if (getUnicodeNormalForm(dirLeft.itemName) !=
+                getUnicodeNormalForm(dirRight.itemName))
                 newFolder.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(newFolder));
 
-        mergeTwoSides(dirLeft.second.second, dirRight.second.second, errorMsgNew, newFolder); //recurse
+        mergeTwoSides(dirLeft.value->cont, dirRight.value->cont, errorMsgNew, newFolder); //recurse
     });
 }
 
@@ -895,8 +1567,8 @@ void stripExcludedDirectories(ContainerObject& hierObj, const PathFilter& filter
 
     //remove superfluous directories:
     //   this does not invalidate "std::vector<FilePair*>& undefinedFiles", since we delete folders only
-    //   and there is no side-effect for memory positions of FilePair and SymlinkPair thanks to std::list!
-    static_assert(std::is_same_v<std::list<FolderPair>, ContainerObject::FolderList>);
+    //   and there is no side-effect for memory positions of FilePair and SymlinkPair thanks to FixedBlockList!
+    static_assert(std::is_same_v<zen::FixedBlockList<FolderPair>, ContainerObject::FolderList>);
 
     hierObj.refSubFolders().remove_if([&](FolderPair& folder)
     {
@@ -913,6 +1585,25 @@ void stripExcludedDirectories(ContainerObject& hierObj, const PathFilter& filter
 }
 
 
+//remove folders existing on both sides that have no child items left after MergeSides dropped soft-filtered items
+//=> nothing lost: active soft filter excludes all folders, see SoftFilter::matchFolder()
+void pruneSoftFilteredFolders(ContainerObject& hierObj)
+{
+    for (FolderPair& folder : hierObj.refSubFolders())
+        pruneSoftFilteredFolders(folder);
+
+    hierObj.refSubFolders().remove_if([](FolderPair& folder)
+    {
+        return folder.getDirCategory() != DIR_CONFLICT && //keep read errors visible on GUI!
+               !folder.isEmpty<SelectSide::left >() &&
+               !folder.isEmpty<SelectSide::right>() &&
+               folder.refSubFolders().empty() &&
+               folder.refSubLinks  ().empty() &&
+               folder.refSubFiles  ().empty();
+    });
+}
+
+
 //create comparison result table and fill category except for files existing on both sides: undefinedFiles and undefinedSymlinks are appended!
 std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const ResolvedFolderPair& fp,
                                                                     const FolderPairCfg& fpCfg,
@@ -926,8 +1617,8 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const Resolv
 
     auto evalFolderContent = [&](const AbstractPath& folderPath) -> const FolderContainer&
     {
-        const DirectoryValue& dirVal = folderBuffer_.find({folderPath, fpCfg.filter.nameFilter, fpCfg.handleSymlinks})->second;
-        //contract: folderBuffer_ has entries for *all* folders (existing or not)
+        const DirectoryValue& dirVal = folderBuffer_.find(getDirectoryKey(folderPath, fpCfg))->second;
+        //contract: folderBuffer_ has entries for both folders (existing or not)
 
         //mix failedFolderReads with failedItemReads:
         //associate folder traversing errors with folder (instead of child items only) to show on GUI! See "MergeSides"
@@ -980,8 +1671,13 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const Resolv
                                                                               fpCfg.compareVar,
                                                                               fileTimeTolerance_,
                                                                               fpCfg.ignoreTimeShiftMinutes);
+    //drop items excluded by soft filter on both sides *before* creating them: no need to keep them as inactive rows
+    //=> but not if sync.ffs_db is used: LastSynchronousStateUpdater would consider them deleted
+    const bool pruneSoftFiltered = fpCfg.pruneSoftFiltered && !fpCfg.filter.timeSizeFilter.isNull() &&
+                                   fpCfg.directionCfg.var != SyncVariant::twoWay && !detectMovedFilesEnabled(fpCfg.directionCfg);
+
     //PERF_START;
-    MergeSides(failedReads, undefinedFiles, undefinedSymlinks).execute(folderContL, folderContR, *output);
+    MergeSides(failedReads, pruneSoftFiltered ? &fpCfg.filter.timeSizeFilter : nullptr, undefinedFiles, undefinedSymlinks).execute(folderContL, folderContR, *output);
     //PERF_STOP;
 
     //##################### in/exclude rows according to filtering #####################
@@ -991,6 +1687,9 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const Resolv
     if (!fpCfg.filter.nameFilter.ref().isNull())
         stripExcludedDirectories(*output, fpCfg.filter.nameFilter.ref()); //mark excluded directories (see parallelDeviceTraversal()) + remove superfluous excluded subdirectories
 
+    if (pruneSoftFiltered)
+        pruneSoftFilteredFolders(*output);
+
     //apply soft filtering (hard filter already applied during traversal!)
     addSoftFiltering(*output, fpCfg.filter.timeSizeFilter);
 
@@ -1007,6 +1706,8 @@ FolderComparison fff::compare(WarningDialogs& warnings,
                               bool createDirLocks,
                               std::unique_ptr<LockHolder>& dirLocks,
                               const std::vector<FolderPairCfg>& fpCfgList,
+                              const ChangeList* changes,
+                              const std::map<AfsDevice, size_t>& deviceParallelOps,
                               ProcessCallback& callback)
 {
     //PERF_START;
@@ -1103,49 +1804,24 @@ FolderComparison fff::compare(WarningDialogs& warnings,
     try
     {
         FolderComparison output;
+        std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates; //load sync.ffs_db only once per folder pair
         //reduce peak memory by restricting lifetime of ComparisonBuffer to have ended when loading potentially huge InSyncFolder instance in redetermineSyncDirection()
         {
-            //------------------- fill directory buffer: traverse/read folders --------------------------
-            std::set<DirectoryKey> folderKeys;
-            for (const auto& [folderPair, fpCfg] : workLoad)
-            {
-                folderKeys.emplace(DirectoryKey({folderPair.folderPathLeft,  fpCfg.filter.nameFilter, fpCfg.handleSymlinks}));
-                folderKeys.emplace(DirectoryKey({folderPair.folderPathRight, fpCfg.filter.nameFilter, fpCfg.handleSymlinks}));
-            }
+            //------------------- traverse/read folders and compare folder pairs --------------------------
+            std::map<DirectoryKey, IncrementalRead> incrementalReads;
+            if (changes)
+                incrementalReads = getIncrementalReads(workLoad, resInfo.baseFolderStatus, fileTimeTolerance, *changes, callback); //throw X
 
             //PERF_START;
-            ComparisonBuffer cmpBuff(folderKeys,
+            ComparisonBuffer cmpBuff(workLoad,
                                      resInfo.baseFolderStatus,
+                                     incrementalReads,
+                                     deviceParallelOps,
                                      fileTimeTolerance, callback);
             //PERF_STOP;
 
             //process binary comparison as one junk
-            std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>> workLoadByContent;
-            for (const auto& [folderPair, fpCfg] : workLoad)
-                if (fpCfg.compareVar == CompareVariant::content)
-                    workLoadByContent.push_back({folderPair, fpCfg});
-
-            std::list<std::shared_ptr<BaseFolderPair>> outputByContent = cmpBuff.compareByContent(workLoadByContent);
-
-            //write output in expected order
-            for (const auto& [folderPair, fpCfg] : workLoad)
-                switch (fpCfg.compareVar)
-                {
-                    case CompareVariant::timeSize:
-                        output.push_back(cmpBuff.compareByTimeSize(folderPair, fpCfg));
-                        break;
-                    case CompareVariant::size:
-                        output.push_back(cmpBuff.compareBySize(folderPair, fpCfg));
-                        break;
-                    case CompareVariant::content:
-                        assert(!outputByContent.empty());
-                        if (!outputByContent.empty())
-                        {
-                            output.push_back(outputByContent.front());
-                            /**/             outputByContent.pop_front();
-                        }
-                        break;
-                }
+            output = cmpBuff.finishComparison(lastSyncStates); //throw X
         }
         assert(output.size() == fpCfgList.size());
 
@@ -1154,7 +1830,7 @@ FolderComparison fff::compare(WarningDialogs& warnings,
         for (auto it = output.begin(); it != output.end(); ++it)
             directCfgs.emplace_back(&** it, fpCfgList[it - output.begin()].directionCfg);
 
-        redetermineSyncDirection(directCfgs,
+        redetermineSyncDirection(directCfgs, std::move(lastSyncStates),
                                  callback); //throw X
 
         return output;
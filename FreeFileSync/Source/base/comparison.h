@@ -11,6 +11,7 @@
 #include "process_callback.h"
 #include "norm_filter.h"
 #include "lock_holder.h"
+#include "change_list.h"
 
 
 namespace fff
@@ -23,14 +24,18 @@ struct FolderPairCfg
                   SymLinkHandling handleSymlinksIn,
                   const std::vector<unsigned int>& ignoreTimeShiftMinutesIn,
                   const NormalizedFilter& filterIn,
-                  const SyncDirectionConfig& directCfg) :
+                  const SyncDirectionConfig& directCfg,
+                  ScanCacheMode scanCacheIn,
+                  bool pruneSoftFilteredIn) :
         folderPathPhraseLeft_ (folderPathPhraseLeft),
         folderPathPhraseRight_(folderPathPhraseRight),
         compareVar(cmpVar),
         handleSymlinks(handleSymlinksIn),
         ignoreTimeShiftMinutes(ignoreTimeShiftMinutesIn),
         filter(filterIn),
-        directionCfg(directCfg) {}
+        directionCfg(directCfg),
+        scanCache(scanCacheIn),
+        pruneSoftFiltered(pruneSoftFilteredIn) {}
 
     Zstring folderPathPhraseLeft_;  //unresolved directory names as entered by user!
     Zstring folderPathPhraseRight_; //
@@ -42,6 +47,9 @@ struct FolderPairCfg
     NormalizedFilter filter;
 
     SyncDirectionConfig directionCfg;
+
+    ScanCacheMode scanCache;
+    bool pruneSoftFiltered;
 };
 
 std::vector<FolderPairCfg> extractCompareCfg(const MainConfiguration& mainCfg); //fill FolderPairCfg and resolve folder pairs
@@ -54,6 +62,8 @@ FolderComparison compare(WarningDialogs& warnings,
                          bool createDirLocks,
                          std::unique_ptr<LockHolder>& dirLocks, //out
                          const std::vector<FolderPairCfg>& fpCfgList,
+                         const ChangeList* changes, //optional: read changed folders only, take the rest from sync.ffs_db
+                         const std::map<AfsDevice, size_t>& deviceParallelOps,
                          ProcessCallback& callback);
 }
 
@@ -24,7 +24,7 @@ namespace
 //-------------------------------------------------------------------------------------------------------------------------------
 const char DB_FILE_DESCR[] = "FreeFileSync";
 const int DB_FILE_VERSION   = 11; //2020-02-07
-const int DB_STREAM_VERSION =  4; //2021-02-14
+const int DB_STREAM_VERSION =  6; //2026-10-16
 //-------------------------------------------------------------------------------------------------------------------------------
 
 DEFINE_NEW_FILE_ERROR(FileErrorDatabaseNotExisting)
@@ -188,7 +188,7 @@ DbStreams loadStreams(const AbstractPath& dbPath, const IoCallback& notifyUnbuff
 class StreamGenerator
 {
 public:
-    static void execute(const InSyncFolder& dbFolder, //throw FileError
+    static void execute(const InSyncFolder& dbFolder, uint64_t cfgFingerprint, //throw FileError
                         const std::wstring& displayFilePathL, //used for diagnostics only
                         const std::wstring& displayFilePathR,
                         std::string& streamL,
@@ -200,6 +200,9 @@ public:
         writeNumber<int32_t>(outL, DB_STREAM_VERSION);
         writeNumber<int32_t>(outR, DB_STREAM_VERSION);
 
+        writeNumber<uint64_t>(outL, cfgFingerprint);
+        writeNumber<uint64_t>(outR, cfgFingerprint);
+
         auto compStream = [&](const std::string& stream) //throw FileError
         {
             try
@@ -266,6 +269,10 @@ private:
 
             writeFileDescr(inSyncData.left);
             writeFileDescr(inSyncData.right);
+
+            writeNumber<int8_t>(streamOutSmallNum_, inSyncData.contentHash ? 1 : 0);
+            if (inSyncData.contentHash)
+                writeArray(streamOutBigNum_, inSyncData.contentHash->data(), inSyncData.contentHash->size());
         }
 
         writeNumber<uint32_t>(streamOutSmallNum_, static_cast<uint32_t>(container.symlinks.size()));
@@ -319,7 +326,8 @@ public:
                                            const std::string& streamL,
                                            const std::string& streamR,
                                            const std::wstring& displayFilePathL, //for diagnostics only
-                                           const std::wstring& displayFilePathR)
+                                           const std::wstring& displayFilePathR,
+                                           std::optional<uint64_t>& cfgFingerprint) //nullopt: not recorded by older versions
     {
         try
         {
@@ -364,8 +372,20 @@ public:
                 return output;
             }
             else if (streamVersion == 3 || //TODO: remove migration code at some time! 2021-02-14
+                     streamVersion == 4 || //TODO: remove migration code at some time! 2026-10-16
+                     streamVersion == 5 || //
                      streamVersion == DB_STREAM_VERSION)
             {
+                if (streamVersion >= 6)
+                {
+                    const uint64_t cfgFingerprintL = readNumber<uint64_t>(streamInL); //throw SysErrorUnexpectedEos
+                    const uint64_t cfgFingerprintR = readNumber<uint64_t>(streamInR); //
+
+                    if (cfgFingerprintL != cfgFingerprintR)
+                        throw SysError(_("File content is corrupted.") + L" (different configuration fingerprints)");
+                    cfgFingerprint = cfgFingerprintL;
+                }
+
                 MemoryStreamIn<std::string>& streamInPart1 = leadStreamLeft ? streamInL : streamInR;
                 MemoryStreamIn<std::string>& streamInPart2 = leadStreamLeft ? streamInR : streamInL;
 
@@ -421,9 +441,17 @@ private:
             const InSyncDescrFile dataL = readFileDescr(); //throw SysErrorUnexpectedEos
             const InSyncDescrFile dataT = readFileDescr(); //
 
+            std::optional<ContentHash> contentHash;
+            if (streamVersion_ >= 5) //TODO: remove migration code at some time! 2026-10-16
+                if (readNumber<int8_t>(streamInSmallNum_) != 0) //throw SysErrorUnexpectedEos
+                {
+                    contentHash = ContentHash();
+                    readArray(streamInBigNum_, contentHash->data(), contentHash->size()); //throw SysErrorUnexpectedEos
+                }
+
             container.addFile(itemName,
                               SelectParam<leadSide>::ref(dataL, dataT),
-                              SelectParam<leadSide>::ref(dataT, dataL), cmpVar, fileSize);
+                              SelectParam<leadSide>::ref(dataT, dataL), cmpVar, fileSize, contentHash);
         }
 
         size_t linkCount = readNumber<uint32_t>(streamInSmallNum_);
@@ -498,7 +526,7 @@ private:
                 /*const auto fileIdL =*/ readContainer<std::string>(inputLeft_);
                 const auto modTimeR = readNumber<int64_t>(inputRight_);
                 /*const auto fileIdR =*/ readContainer<std::string>(inputRight_);
-                container.addFile(itemName, InSyncDescrFile(modTimeL, AFS::FingerPrint()), InSyncDescrFile(modTimeR, AFS::FingerPrint()), cmpVar, fileSize);
+                container.addFile(itemName, InSyncDescrFile(modTimeL, AFS::FingerPrint()), InSyncDescrFile(modTimeR, AFS::FingerPrint()), cmpVar, fileSize, std::nullopt);
             }
 
             size_t linkCount = readNumber<uint32_t>(inputBoth_);
@@ -561,6 +589,15 @@ private:
         process(hierObj.refSubFolders(), hierObj.getRelativePathAny(), dbFolder.folders);
     }
 
+    std::optional<ContentHash> getContentHash(const FilePair& file) const
+    {
+        if (activeCmpVar_ == CompareVariant::content ||
+            activeCmpVar_ == CompareVariant::hash)
+            if (const ContentHash* contentHash = file.base().getContentHash(file))
+                return *contentHash;
+        return std::nullopt;
+    }
+
     void process(const ContainerObject::FileList& currentFiles, const Zstring& parentRelPath, InSyncFolder::FileList& dbFiles)
     {
         std::set<Zstring, LessUnicodeNormal> toPreserve;
@@ -582,7 +619,8 @@ private:
                                                         InSyncDescrFile(file.getLastWriteTime<SelectSide::right>(),
                                                                         file.getFilePrint    <SelectSide::right>()),
                                                         activeCmpVar_,
-                                                        file.getFileSize<SelectSide::left>()));
+                                                        file.getFileSize<SelectSide::left>(),
+                                                        getContentHash(file)));
                     toPreserve.insert(file.getItemNameAny());
                 }
                 else //not in sync: preserve last synchronous state
@@ -759,8 +797,19 @@ std::pair<DbStreams::const_iterator,
 
 //#######################################################################################################################################
 
+uint64_t fff::getDbConfigFingerprint(const PathFilter& filter, CompareVariant cmpVar, SymLinkHandling handleSymlinks)
+{
+    FNV1aHash<uint64_t> hash;
+    filter.addFingerprint(hash);
+    hash.add(static_cast<uint64_t>(cmpVar));
+    hash.add(static_cast<uint64_t>(handleSymlinks));
+    return hash.get();
+}
+
+
 std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> fff::loadLastSynchronousState(const std::vector<const BaseFolderPair*>& baseFolders,
-                                                                      PhaseCallback& callback /*throw X*/) //throw X
+                                                                      PhaseCallback& callback /*throw X*/, //throw X
+                                                                      std::unordered_map<const BaseFolderPair*, uint64_t>* cfgFingerprints)
 {
     std::set<AbstractPath> dbFilePaths;
 
@@ -828,12 +877,16 @@ std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> fff::lo
                     if (itStreamL != streamsL.end())
                     {
                         assert(itStreamL->second.isLeadStream != itStreamR->second.isLeadStream);
+                        std::optional<uint64_t> cfgFingerprint;
                         SharedRef<InSyncFolder> lastSyncState = StreamParser::execute(itStreamL->second.isLeadStream,
                                                                                       itStreamL->second.rawStream,
                                                                                       itStreamR->second.rawStream,
                                                                                       AFS::getDisplayPath(dbPathL),
-                                                                                      AFS::getDisplayPath(dbPathR)); //throw FileError
+                                                                                      AFS::getDisplayPath(dbPathR), cfgFingerprint); //throw FileError
                         output.emplace(baseFolder, lastSyncState);
+
+                        if (cfgFingerprints && cfgFingerprint)
+                            cfgFingerprints->emplace(baseFolder, *cfgFingerprint);
                     }
                 }
                 catch (const FileError& e) { callback.reportFatalError(e.toString()); } //throw X
@@ -843,7 +896,7 @@ std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> fff::lo
 }
 
 
-void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transactionalCopy,
+void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, SymLinkHandling handleSymlinks, bool transactionalCopy,
                                    PhaseCallback& callback /*throw X*/) //throw X
 {
     const AbstractPath dbPathL = getDatabaseFilePath<SelectSide::left >(baseFolder);
@@ -896,11 +949,14 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transa
                                                                  AFS::getDisplayPath(dbPathL),
                                                                  AFS::getDisplayPath(dbPathR)); //throw FileError
         if (itStreamOldL != streamsL.end())
+        {
+            std::optional<uint64_t> cfgFingerprintOld; //replaced by current settings below
             lastSyncState = std::move(StreamParser::execute(itStreamOldL->second.isLeadStream /*leadStreamLeft*/,
                                                             itStreamOldL->second.rawStream,
                                                             itStreamOldR->second.rawStream,
                                                             AFS::getDisplayPath(dbPathL),
-                                                            AFS::getDisplayPath(dbPathR)).ref()); //throw FileError
+                                                            AFS::getDisplayPath(dbPathR), cfgFingerprintOld).ref()); //throw FileError
+        }
     }
     catch (const FileError& e) { callback.reportFatalError(e.toString()); } //throw X
     //if database files are corrupted: just overwrite! User is already informed about errors right after comparing!
@@ -916,7 +972,7 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transa
 
     if (const std::wstring errMsg = tryReportingError([&] //throw X
 {
-    StreamGenerator::execute(lastSyncState, //throw FileError
+    StreamGenerator::execute(lastSyncState, getDbConfigFingerprint(baseFolder.getFilter(), baseFolder.getCompVariant(), handleSymlinks), //throw FileError
                              AFS::getDisplayPath(dbPathL),
                              AFS::getDisplayPath(dbPathR),
                              sessionDataL.rawStream,
@@ -38,11 +38,13 @@ struct InSyncDescrLink
 //artificial hierarchy of last synchronous state:
 struct InSyncFile
 {
-    InSyncFile(const InSyncDescrFile& l, const InSyncDescrFile& r, CompareVariant cv, uint64_t fileSizeIn) : left(l), right(r), cmpVar(cv), fileSize(fileSizeIn) {}
+    InSyncFile(const InSyncDescrFile& l, const InSyncDescrFile& r, CompareVariant cv, uint64_t fileSizeIn, const std::optional<ContentHash>& contentHashIn) :
+        left(l), right(r), cmpVar(cv), fileSize(fileSizeIn), contentHash(contentHashIn) {}
     InSyncDescrFile left;  //support flip()!
     InSyncDescrFile right; //
     CompareVariant cmpVar = CompareVariant::timeSize; //the one active while finding "file in sync"
     uint64_t fileSize = 0; //file size must be identical on both sides!
+    std::optional<ContentHash> contentHash; //CompareVariant::content, CompareVariant::hash only: content is identical on both sides => one hash is enough
 };
 
 struct InSyncSymlink
@@ -82,9 +84,10 @@ struct InSyncFolder
         return folders.emplace(folderName, InSyncFolder(st)).first->second;
     }
 
-    void addFile(const Zstring& fileName, const InSyncDescrFile& dataL, const InSyncDescrFile& dataR, CompareVariant cmpVar, uint64_t fileSize)
+    void addFile(const Zstring& fileName, const InSyncDescrFile& dataL, const InSyncDescrFile& dataR, CompareVariant cmpVar, uint64_t fileSize,
+                 const std::optional<ContentHash>& contentHash)
     {
-        files.emplace(fileName, InSyncFile(dataL, dataR, cmpVar, fileSize));
+        files.emplace(fileName, InSyncFile(dataL, dataR, cmpVar, fileSize, contentHash));
     }
 
     void addSymlink(const Zstring& linkName, const InSyncDescrLink& dataL, const InSyncDescrLink& dataR, CompareVariant cmpVar)
@@ -94,10 +97,14 @@ struct InSyncFolder
 };
 
 
+//settings that determine the content of sync.ffs_db: incremental comparison must not take items from a database recorded with different ones
+uint64_t getDbConfigFingerprint(const PathFilter& filter, CompareVariant cmpVar, SymLinkHandling handleSymlinks);
+
 std::unordered_map<const BaseFolderPair*, zen::SharedRef<const InSyncFolder>> loadLastSynchronousState(const std::vector<const BaseFolderPair*>& baseFolders,
-                                                                           PhaseCallback& callback /*throw X*/); //throw X
+                                                                           PhaseCallback& callback /*throw X*/, //throw X
+                                                                           std::unordered_map<const BaseFolderPair*, uint64_t>* cfgFingerprints = nullptr); //missing for databases of older versions
 
-void saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transactionalCopy, //throw X
+void saveLastSynchronousState(const BaseFolderPair& baseFolder, SymLinkHandling handleSymlinks, bool transactionalCopy, //throw X
                               PhaseCallback& callback /*throw X*/);
 }
 
@@ -55,6 +55,65 @@ std::wstring fff::getShortDisplayNameForFolderPair(const AbstractPath& itemPathL
 }
 
 
+FolderContainer* FolderContainer::findSubFolder(const Zstring& itemName)
+{
+    auto it = std::find_if(folders.begin(), folders.end(), [&](const auto& item) { return item.itemName == itemName; });
+    return it != folders.end() ? &it->value->cont : nullptr;
+}
+
+
+namespace
+{
+template <class ItemList, class Function>
+void removeDuplicateItems(ItemList& items, Function selectItem)
+{
+    if (std::adjacent_find(items.begin(), items.end(), [](const auto& lhs, const auto& rhs) { return !(lhs.itemName < rhs.itemName); }) == items.end())
+        return; //sorted already, no duplicates
+
+    std::stable_sort(items.begin(), items.end(), [](const auto& lhs, const auto& rhs) { return lhs.itemName < rhs.itemName; });
+
+    auto itOut = items.begin();
+    for (auto it = items.begin(); it != items.end();)
+    {
+        auto itEndEq = std::find_if(it + 1, items.end(), [&](const auto& item) { return item.itemName != it->itemName; });
+
+        auto itSel = selectItem(it, itEndEq);
+        if (itOut != itSel)
+            *itOut = std::move(*itSel);
+        ++itOut;
+        it = itEndEq;
+    }
+    items.erase(itOut, items.end());
+}
+}
+
+
+void FolderContainer::removeDuplicates()
+{
+    auto selectLast = [](auto it, auto itEnd) { return itEnd - 1; };
+
+    removeDuplicateItems(files,    selectLast);
+    removeDuplicateItems(symlinks, selectLast);
+
+    //keep latest non-empty folder: e.g. parent of a sub folder read is read non-recursively, too (see parallelDeviceTraversal())
+    removeDuplicateItems(folders, [](auto it, auto itEnd)
+    {
+        auto itSel = itEnd - 1;
+        if (itSel->value->cont.isEmpty())
+            for (auto it2 = itSel; it2 != it;)
+                if (!(--it2)->value->cont.isEmpty())
+                {
+                    it2->value->attr = itSel->value->attr;
+                    return it2;
+                }
+        return itSel;
+    });
+
+    for (auto& item : folders)
+        item.value->cont.removeDuplicates();
+}
+
+
 void ContainerObject::removeEmptyRec()
 {
     bool emptyExisting = false;
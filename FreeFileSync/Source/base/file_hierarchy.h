@@ -8,13 +8,17 @@
 #define FILE_HIERARCHY_H_257235289645296
 
 #include <map>
+#include <array>
+#include <vector>
 #include <string>
 #include <memory>
 #include <list>
 #include <functional>
 #include <unordered_set>
+#include <unordered_map>
 #include <zen/zstring.h>
 #include <zen/stl_tools.h>
+#include <zen/fixed_list.h>
 #include "structures.h"
 #include "path_filter.h"
 #include "../afs/abstract.h"
@@ -46,6 +50,9 @@ struct FileAttributes
 };
 
 
+using ContentHash = std::array<unsigned char, 32>; //SHA-256 of file content
+
+
 struct LinkAttributes
 {
     LinkAttributes() {}
@@ -104,12 +111,25 @@ std::wstring getShortDisplayNameForFolderPair(const AbstractPath& itemPathL, con
 
 //------------------------------------------------------------------
 
+/* raw folder content during traversal: flat vectors instead of std::map
+    - no tree node per item: memory is a significant scaling limit for huge folder hierarchies
+    - items are appended in traversal order => call removeDuplicates() when traversal is completed
+    - item names are ref-counted Zstring: shared with FileSystemObject after MergeSides => no need for a separate string arena */
 struct FolderContainer
 {
     //------------------------------------------------------------------
-    using FolderList  = std::map<Zstring, std::pair<FolderAttributes, FolderContainer>>; //
-    using FileList    = std::map<Zstring, FileAttributes>; //key: raw file name, without any (Unicode) normalization, preserving original upper-/lower-case
-    using SymlinkList = std::map<Zstring, LinkAttributes>; //"Changing data [...] to NFC would cause interoperability problems. Always leave data as it is."
+    template <class Value>
+    struct Item
+    {
+        Zstring itemName; //raw file name, without any (Unicode) normalization, preserving original upper-/lower-case
+        //"Changing data [...] to NFC would cause interoperability problems. Always leave data as it is."
+        Value value;
+    };
+
+    struct SubFolder;
+    using FolderList  = std::vector<Item<std::unique_ptr<SubFolder>>>; //pointer-stable: child folders are filled while parent is still being read
+    using FileList    = std::vector<Item<FileAttributes>>;
+    using SymlinkList = std::vector<Item<LinkAttributes>>;
     //------------------------------------------------------------------
 
     FolderContainer() = default;
@@ -120,38 +140,139 @@ struct FolderContainer
     SymlinkList symlinks; //non-followed symlinks
     FolderList  folders;
 
-    void addSubFile(const Zstring& itemName, const FileAttributes& attr)
+    void addSubFile(const Zstring& itemName, const FileAttributes& attr) { files.push_back({itemName, attr}); }
+
+    void addSubLink(const Zstring& itemName, const LinkAttributes& attr) { symlinks.push_back({itemName, attr}); }
+
+    FolderContainer& addSubFolder(const Zstring& itemName, const FolderAttributes& attr);
+
+    FolderContainer* findSubFolder(const Zstring& itemName); //linear search!
+
+    bool isEmpty() const { return files.empty() && symlinks.empty() && folders.empty(); }
+
+    //sort by name and remove duplicates, e.g. due to folder traverser "retry": keep latest entry
+    void removeDuplicates(); //recursive
+};
+
+
+struct FolderContainer::SubFolder
+{
+    explicit SubFolder(const FolderAttributes& attrIn) : attr(attrIn) {}
+
+    FolderAttributes attr;
+    FolderContainer cont;
+};
+
+
+inline
+FolderContainer& FolderContainer::addSubFolder(const Zstring& itemName, const FolderAttributes& attr)
+{
+    folders.push_back({itemName, std::make_unique<SubFolder>(attr)});
+    return folders.back().value->cont;
+}
+
+
+class BaseFolderPair;
+class FolderPair;
+class FilePair;
+class SymlinkPair;
+class FileSystemObject;
+
+//inherit from this class to allow safe random access by id instead of unsafe raw pointer
+//allow for similar semantics like std::weak_ptr without having to use std::shared_ptr
+template <class T>
+class ObjectMgr
+{
+    template <bool isConst> class Id;
+public:
+    using ObjectId      = Id<false>;
+    using ObjectIdConst = Id<true>;
+
+    ObjectIdConst  getId() const { return {slotIdx_, slots_[slotIdx_].generation}; }
+    /**/  ObjectId getId()       { return {slotIdx_, slots_[slotIdx_].generation}; }
+
+    static const T* retrieve(ObjectIdConst id) //returns nullptr if object is not valid anymore
     {
-        const auto [it, inserted] = files.emplace(itemName, attr);
-        if (!inserted) //update entry if already existing (e.g. during folder traverser "retry")
-            it->second = attr;
+        if (id.slotIdx_ < slots_.size())
+            if (const Slot& slot = slots_[id.slotIdx_];
+                slot.generation == id.generation_)
+                return static_cast<const T*>(slot.obj); //nullptr for unused slot
+        return nullptr;
     }
+    static T* retrieve(ObjectId id) { return const_cast<T*>(retrieve(static_cast<ObjectIdConst>(id))); }
+
+    struct IdHash { size_t operator()(ObjectIdConst id) const { return std::hash<uint64_t>()(uint64_t(id.generation_) << 32 | id.slotIdx_); } };
 
-    void addSubLink(const Zstring& itemName, const LinkAttributes& attr)
+protected:
+    ObjectMgr()
     {
-        const auto [it, inserted] = symlinks.emplace(itemName, attr);
-        if (!inserted)
-            it->second = attr;
+        if (firstFreeSlot_ == 0) //no free slot
+        {
+            if (slots_.size() == std::numeric_limits<uint32_t>::max())
+                throw std::length_error("ObjectMgr: too many objects");
+            slotIdx_ = static_cast<uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        else
+        {
+            slotIdx_ = firstFreeSlot_;
+            firstFreeSlot_ = slots_[slotIdx_].nextFree;
+        }
+        slots_[slotIdx_].obj = this;
     }
 
-    FolderContainer& addSubFolder(const Zstring& itemName, const FolderAttributes& attr)
+    ~ObjectMgr()
     {
-        auto& p = folders[itemName]; //value default-construction is okay here
-        p.first = attr;
-        return p.second;
-
-        //const auto [it, inserted] = folders.emplace(itemName, std::pair<FolderAttributes, FolderContainer>(attr, FolderContainer()));
-        //if (!inserted)
-        //  it->second.first = attr;
-        //return it->second.second;
+        Slot& slot = slots_[slotIdx_];
+        slot.obj = nullptr;
+        ++slot.generation; //invalidate all ids of this object (4 billion reuses of the same slot before wrap-around: fine)
+        slot.nextFree = firstFreeSlot_;
+        firstFreeSlot_ = slotIdx_;
     }
+
+private:
+    ObjectMgr           (const ObjectMgr& rhs) = delete;
+    ObjectMgr& operator=(const ObjectMgr& rhs) = delete; //it's not well-defined what copying an objects means regarding object-identity in this context
+
+    //slot map: O(1) lookup without hashing, 16 bytes per object and dense (previously: std::unordered_set<const ObjectMgr*>)
+    struct Slot
+    {
+        const ObjectMgr* obj = nullptr; //nullptr: slot is unused
+        uint32_t generation = 0;
+        uint32_t nextFree = 0; //intrusive list of unused slots (if obj == nullptr); 0: end of list
+    };
+
+    uint32_t slotIdx_ = 0;
+
+    //our global ObjectMgr is not thread-safe (and currently does not need to be!)
+    //assert(runningOnMainThread()); -> still, may be accessed by synchronization worker threads, one thread at a time
+    static inline std::vector<Slot> slots_{Slot()}; //external linkage! slot 0 is reserved => ObjectId() is "nullptr"
+    static inline uint32_t firstFreeSlot_ = 0;      //
+};
+
+
+template <class T>
+template <bool isConst>
+class ObjectMgr<T>::Id
+{
+public:
+    Id() {}
+    Id(std::nullptr_t) {}
+    Id(const Id<!isConst>& id) requires isConst : slotIdx_(id.slotIdx_), generation_(id.generation_) {} //ObjectId -> ObjectIdConst, but not vice versa
+
+    explicit operator bool() const { return slotIdx_ != 0; }
+
+    bool operator==(const Id&) const = default;
+
+private:
+    Id(uint32_t slotIdx, uint32_t generation) : slotIdx_(slotIdx), generation_(generation) {}
+    friend class ObjectMgr;
+    friend class Id<!isConst>;
+
+    uint32_t slotIdx_    = 0;
+    uint32_t generation_ = 0;
 };
 
-class BaseFolderPair;
-class FolderPair;
-class FilePair;
-class SymlinkPair;
-class FileSystemObject;
 
 /*------------------------------------------------------------------
     inheritance diagram:
@@ -198,9 +319,9 @@ class ContainerObject : public virtual PathInformation
     friend class FileSystemObject;
 
 public:
-    using FileList    = std::list<FilePair>;    //MergeSides::execute() requires a structure that doesn't invalidate pointers after push_back()
-    using SymlinkList = std::list<SymlinkPair>; //
-    using FolderList  = std::list<FolderPair>;
+    using FileList    = zen::FixedBlockList<FilePair>;    //MergeSides::execute() requires a structure that doesn't invalidate pointers after push_back()
+    using SymlinkList = zen::FixedBlockList<SymlinkPair>; //
+    using FolderList  = zen::FixedBlockList<FolderPair>;
 
     FolderPair& addSubFolder(const Zstring&          itemNameL,
                              const FolderAttributes& left,    //file exists on both sides
@@ -317,10 +438,16 @@ public:
 
     void flip() override;
 
+    //CompareVariant::content, CompareVariant::hash: files found to have the same content => persisted in sync.ffs_db
+    void setContentHash(const FilePair& file, const ContentHash& hash);
+    const ContentHash* getContentHash(const FilePair& file) const; //nullptr if not available
+
 private:
     AbstractPath getAbstractPathL() const override { return folderPathLeft_; }
     AbstractPath getAbstractPathR() const override { return folderPathRight_; }
 
+    std::unordered_map<ObjectMgr<FileSystemObject>::ObjectIdConst, ContentHash, ObjectMgr<FileSystemObject>::IdHash> contentHashes_; //avoid memory overhead per FilePair
+
     const FilterRef filter_; //filter used while scanning directory: represents sub-view of actual files!
     const CompareVariant cmpVar_;
     const int fileTimeTolerance_;
@@ -380,37 +507,6 @@ struct FSObjectVisitor
 };
 
 
-//inherit from this class to allow safe random access by id instead of unsafe raw pointer
-//allow for similar semantics like std::weak_ptr without having to use std::shared_ptr
-template <class T>
-class ObjectMgr
-{
-public:
-    using ObjectId      =       ObjectMgr*;
-    using ObjectIdConst = const ObjectMgr*;
-
-    ObjectIdConst  getId() const { return this; }
-    /**/  ObjectId getId()       { return this; }
-
-    static const T* retrieve(ObjectIdConst id) //returns nullptr if object is not valid anymore
-    {
-        return static_cast<const T*>(activeObjects_.contains(id) ? id : nullptr);
-    }
-    static T* retrieve(ObjectId id) { return const_cast<T*>(retrieve(static_cast<ObjectIdConst>(id))); }
-
-protected:
-    ObjectMgr () { activeObjects_.insert(this); }
-    ~ObjectMgr() { activeObjects_.erase (this); }
-
-private:
-    ObjectMgr           (const ObjectMgr& rhs) = delete;
-    ObjectMgr& operator=(const ObjectMgr& rhs) = delete; //it's not well-defined what copying an objects means regarding object-identity in this context
-
-    //our global ObjectMgr is not thread-safe (and currently does not need to be!)
-    //assert(runningOnMainThread()); -> still, may be accessed by synchronization worker threads, one thread at a time
-    static inline std::unordered_set<const ObjectMgr*> activeObjects_; //external linkage!
-};
-
 //------------------------------------------------------------------
 
 class FileSystemObject : public ObjectMgr<FileSystemObject>, public virtual PathInformation
@@ -966,24 +1062,21 @@ FolderPair& ContainerObject::addSubFolder(const Zstring& itemNameL,
                                           const Zstring& itemNameR,
                                           const FolderAttributes& right)
 {
-    subFolders_.emplace_back(itemNameL, left, defaultCmpResult, itemNameR, right, *this);
-    return subFolders_.back();
+    return subFolders_.emplace_back(itemNameL, left, defaultCmpResult, itemNameR, right, *this);
 }
 
 
 template <> inline
 FolderPair& ContainerObject::addSubFolder<SelectSide::left>(const Zstring& itemName, const FolderAttributes& attr)
 {
-    subFolders_.emplace_back(itemName, attr, DIR_LEFT_SIDE_ONLY, Zstring(), FolderAttributes(), *this);
-    return subFolders_.back();
+    return subFolders_.emplace_back(itemName, attr, DIR_LEFT_SIDE_ONLY, Zstring(), FolderAttributes(), *this);
 }
 
 
 template <> inline
 FolderPair& ContainerObject::addSubFolder<SelectSide::right>(const Zstring& itemName, const FolderAttributes& attr)
 {
-    subFolders_.emplace_back(Zstring(), FolderAttributes(), DIR_RIGHT_SIDE_ONLY, itemName, attr, *this);
-    return subFolders_.back();
+    return subFolders_.emplace_back(Zstring(), FolderAttributes(), DIR_RIGHT_SIDE_ONLY, itemName, attr, *this);
 }
 
 
@@ -994,24 +1087,21 @@ FilePair& ContainerObject::addSubFile(const Zstring&        itemNameL,
                                       const Zstring&        itemNameR,
                                       const FileAttributes& right)
 {
-    subFiles_.emplace_back(itemNameL, left, defaultCmpResult, itemNameR, right, *this);
-    return subFiles_.back();
+    return subFiles_.emplace_back(itemNameL, left, defaultCmpResult, itemNameR, right, *this);
 }
 
 
 template <> inline
 FilePair& ContainerObject::addSubFile<SelectSide::left>(const Zstring& itemName, const FileAttributes& attr)
 {
-    subFiles_.emplace_back(itemName, attr, FILE_LEFT_SIDE_ONLY, Zstring(), FileAttributes(), *this);
-    return subFiles_.back();
+    return subFiles_.emplace_back(itemName, attr, FILE_LEFT_SIDE_ONLY, Zstring(), FileAttributes(), *this);
 }
 
 
 template <> inline
 FilePair& ContainerObject::addSubFile<SelectSide::right>(const Zstring& itemName, const FileAttributes& attr)
 {
-    subFiles_.emplace_back(Zstring(), FileAttributes(), FILE_RIGHT_SIDE_ONLY, itemName, attr, *this);
-    return subFiles_.back();
+    return subFiles_.emplace_back(Zstring(), FileAttributes(), FILE_RIGHT_SIDE_ONLY, itemName, attr, *this);
 }
 
 
@@ -1022,24 +1112,21 @@ SymlinkPair& ContainerObject::addSubLink(const Zstring&        itemNameL,
                                          const Zstring&        itemNameR,
                                          const LinkAttributes& right)
 {
-    subLinks_.emplace_back(itemNameL, left, defaultCmpResult, itemNameR, right, *this);
-    return subLinks_.back();
+    return subLinks_.emplace_back(itemNameL, left, defaultCmpResult, itemNameR, right, *this);
 }
 
 
 template <> inline
 SymlinkPair& ContainerObject::addSubLink<SelectSide::left>(const Zstring& itemName, const LinkAttributes& attr)
 {
-    subLinks_.emplace_back(itemName, attr, SYMLINK_LEFT_SIDE_ONLY, Zstring(), LinkAttributes(), *this);
-    return subLinks_.back();
+    return subLinks_.emplace_back(itemName, attr, SYMLINK_LEFT_SIDE_ONLY, Zstring(), LinkAttributes(), *this);
 }
 
 
 template <> inline
 SymlinkPair& ContainerObject::addSubLink<SelectSide::right>(const Zstring& itemName, const LinkAttributes& attr)
 {
-    subLinks_.emplace_back(Zstring(), LinkAttributes(), SYMLINK_RIGHT_SIDE_ONLY, itemName, attr, *this);
-    return subLinks_.back();
+    return subLinks_.emplace_back(Zstring(), LinkAttributes(), SYMLINK_RIGHT_SIDE_ONLY, itemName, attr, *this);
 }
 
 
@@ -1103,6 +1190,22 @@ void BaseFolderPair::setFolderStatus(BaseFolderStatus value)
 }
 
 
+inline
+void BaseFolderPair::setContentHash(const FilePair& file, const ContentHash& hash)
+{
+    assert(&file.base() == this);
+    contentHashes_.insert_or_assign(file.getId(), hash);
+}
+
+
+inline
+const ContentHash* BaseFolderPair::getContentHash(const FilePair& file) const
+{
+    auto it = contentHashes_.find(file.getId());
+    return it != contentHashes_.end() ? &it->second : nullptr;
+}
+
+
 inline
 void FilePair::flip()
 {
@@ -10,6 +10,7 @@
 //#include <zen/basic_math.h>
 #include <zen/thread.h>
 #include <zen/scope_guard.h>
+#include "scan_cache.h"
 
 using namespace zen;
 using namespace fff;
@@ -70,7 +71,8 @@ public:
     }
 
     //context of main thread
-    void waitUntilDone(std::chrono::milliseconds duration, const TravErrorCb& onError, const TravStatusCb& onStatusUpdate) //throw X
+    void waitUntilDone(std::chrono::milliseconds duration, const TravErrorCb& onError, const TravStatusCb& onStatusUpdate, //throw X
+                       const std::function<void(int threadIdx)>& onThreadDone /*throw X*/)
     {
         assert(runningOnMainThread());
         for (;;)
@@ -79,10 +81,22 @@ public:
 
             for (std::unique_lock dummy(lockRequest_) ;;) //process all errors without delay
             {
-                const bool rv = conditionNewRequest.wait_until(dummy, callbackTime, [this] { return (errorRequest_ && !errorResponse_) || (threadsToFinish_ == 0); });
+                const bool rv = conditionNewRequest.wait_until(dummy, callbackTime, [this] { return (errorRequest_ && !errorResponse_) || !threadsDone_.empty() || (threadsToFinish_ == 0); });
                 if (!rv) //time-out + condition not met
                     break;
 
+                if (!threadsDone_.empty())
+                {
+                    std::vector<int> threadsDone;
+                    threadsDone.swap(threadsDone_);
+
+                    dummy.unlock(); //don't block worker threads while processing their results
+                    for (const int threadIdx : threadsDone)
+                        onThreadDone(threadIdx); //throw X
+                    dummy.lock();
+                    continue; //re-evaluate: mutex was unlocked
+                }
+
                 if (errorRequest_ && !errorResponse_)
                 {
                     assert(threadsToFinish_ != 0);
@@ -158,8 +172,9 @@ public:
         {
             std::lock_guard dummy(lockRequest_);
             assert(threadsToFinish_ > 0);
-            if (--threadsToFinish_ == 0)
-                conditionNewRequest.notify_all(); //perf: should unlock mutex before notify!? (insignificant)
+            --threadsToFinish_;
+            threadsDone_.push_back(threadIdx);
+            conditionNewRequest.notify_all(); //perf: should unlock mutex before notify!? (insignificant)
         }
     }
 
@@ -172,7 +187,8 @@ private:
         std::wstring filePath;
         {
             std::lock_guard dummy(lockCurrentStatus_);
-            parallelOpsTotal = activeThreadIdxs_.size();
+            for (const auto& [threadIdx, parallelOps] : activeThreadIdxs_)
+                parallelOpsTotal += parallelOps;
             filePath = currentFile_;
         }
         if (parallelOpsTotal >= 2)
@@ -189,6 +205,7 @@ private:
     std::optional<AFS::TraverserCallback::ErrorInfo  > errorRequest_;
     std::optional<AFS::TraverserCallback::HandleError> errorResponse_;
     size_t threadsToFinish_; //can't use activeThreadIdxs_.size() which is locked by different mutex!
+    std::vector<int> threadsDone_; //not yet reported to main thread
     //also note: activeThreadIdxs_.size() may be 0 during worker thread construction!
 
     //---- status updates ----
@@ -205,6 +222,17 @@ private:
 
 //-------------------------------------------------------------------------------------------------
 
+struct ScanCacheState
+{
+    const ScanCacheMode mode;
+    const ScanCacheFile cacheFile;
+
+    ScanCache oldCache; //from last scan
+    ScanCache newCache; //this scan: only folders read without errors
+    std::map<Zstring, AFS::TraverserCallback::FolderListing> verifyListings; //ScanCacheMode::verify: cached content of folders with unchanged fingerprint
+};
+
+
 struct TraverserConfig
 {
     const AbstractPath baseFolderPath;  //thread-safe like an int! :)
@@ -216,7 +244,9 @@ struct TraverserConfig
 
     AsyncCallback& acb;
     const int threadIdx;
-    std::chrono::steady_clock::time_point& lastReportTime; //thread-level
+    std::chrono::steady_clock::time_point& lastReportTime; //device-level: TraverserCallback calls are serialized, even for parallelOps > 1
+
+    ScanCacheState* scanCache; //optional
 };
 
 
@@ -226,19 +256,25 @@ public:
     DirCallback(TraverserConfig& cfg,
                 const Zstring& parentRelPathPf, //postfixed with FILE_NAME_SEPARATOR!
                 FolderContainer& output,
-                int level) :
+                int level,
+                bool recursive = true) :
         cfg_(cfg),
         parentRelPathPf_(parentRelPathPf),
         output_(output),
-        level_(level) {} //MUST NOT use cfg_ during construction! see BaseDirCallback()
+        level_(level),
+        recursive_(recursive) {} //MUST NOT use cfg_ during construction! see BaseDirCallback()
 
     virtual void                               onFile   (const AFS::FileInfo&    fi) override; //
     virtual std::shared_ptr<TraverserCallback> onFolder (const AFS::FolderInfo&  fi) override; //throw ThreadStopRequest
     virtual HandleLink                         onSymlink(const AFS::SymlinkInfo& li) override; //
+    bool mayReportItem(const Zstring& itemName, std::optional<AFS::ItemType> itemType) override;
 
     HandleError reportDirError (const ErrorInfo& errorInfo)                          override  { return reportError(errorInfo, Zstring()); } //throw ThreadStopRequest
     HandleError reportItemError(const ErrorInfo& errorInfo, const Zstring& itemName) override  { return reportError(errorInfo, itemName);  } //
 
+    bool cachesFolderContent() const override { return cfg_.scanCache; }
+    const FolderListing* onFolderOpened(const AFS::FolderFingerprint& fp) override;
+
 private:
     HandleError reportError(const ErrorInfo& errorInfo, const Zstring& itemName /*optional*/); //throw ThreadStopRequest
 
@@ -246,6 +282,8 @@ private:
     const Zstring parentRelPathPf_;
     FolderContainer& output_;
     const int level_;
+    const bool recursive_;
+    FolderListing* cacheListing_ = nullptr; //record unfiltered folder content; owned by cfg_.scanCache->newCache
 };
 
 
@@ -253,8 +291,13 @@ class BaseDirCallback : public DirCallback
 {
 public:
     BaseDirCallback(const DirectoryKey& baseFolderKey, DirectoryValue& output,
-                    AsyncCallback& acb, int threadIdx, std::chrono::steady_clock::time_point& lastReportTime) :
-        DirCallback(travCfg_ /*not yet constructed!!!*/, Zstring(), output.folderCont, 0 /*level*/),
+                    AsyncCallback& acb, int threadIdx, std::chrono::steady_clock::time_point& lastReportTime, ScanCacheState* scanCache /*optional*/,
+                    const SubFolderRead& subRead, FolderContainer& subFolderCont) :
+        DirCallback(travCfg_ /*not yet constructed!!!*/,
+                    subRead.relPath.empty() ? Zstring() : subRead.relPath + FILE_NAME_SEPARATOR,
+                    subFolderCont,
+                    static_cast<int>(std::count(subRead.relPath.begin(), subRead.relPath.end(), FILE_NAME_SEPARATOR)) + (subRead.relPath.empty() ? 0 : 1) /*level*/,
+                    subRead.recursive),
         travCfg_
     {
         baseFolderKey.folderPath,
@@ -264,11 +307,12 @@ public:
         output.failedItemReads,
         acb,
         threadIdx,
-        lastReportTime
+        lastReportTime,
+        scanCache
     }
     {
         if (acb.mayReportCurrentFile(threadIdx, lastReportTime))
-            acb.reportCurrentFile(AFS::getDisplayPath(baseFolderKey.folderPath)); //just in case first directory access is blocking
+            acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(baseFolderKey.folderPath, subRead.relPath))); //just in case first directory access is blocking
     }
 
 private:
@@ -286,6 +330,8 @@ void DirCallback::onFile(const AFS::FileInfo& fi) //throw ThreadStopRequest
     if (cfg_.acb.mayReportCurrentFile(cfg_.threadIdx, cfg_.lastReportTime))
         cfg_.acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_.baseFolderPath, relPath)));
 
+    if (cacheListing_ && !fi.isFollowedSymlink) //followed symlinks are resolved again when replaying onSymlink()
+        cacheListing_->files.push_back(fi);
     //------------------------------------------------------------------------------------
     //apply filter before processing (use relative name!)
     if (!cfg_.filter.ref().passFileFilter(relPath))
@@ -309,6 +355,48 @@ void DirCallback::onFile(const AFS::FileInfo& fi) //throw ThreadStopRequest
 }
 
 
+bool DirCallback::mayReportItem(const Zstring& itemName, std::optional<AFS::ItemType> itemType)
+{
+    if (cacheListing_) //scan cache needs attributes of excluded items, too
+        return true;
+
+    const Zstring& relPath = parentRelPathPf_ + itemName;
+
+    const auto passFileFilter = [&] { return cfg_.filter.ref().passFileFilter(relPath); };
+    const auto passDirFilter  = [&] //same as onFolder(): excluded folders are still traversed if a child item might match
+    {
+        bool childItemMightMatch = true;
+        return cfg_.filter.ref().passDirFilter(relPath, &childItemMightMatch) || childItemMightMatch;
+    };
+
+    if (!itemType) //d_type not available: could be anything
+        return passFileFilter() || passDirFilter();
+
+    switch (*itemType)
+    {
+        case AFS::ItemType::file:
+            return passFileFilter();
+
+        case AFS::ItemType::folder:
+            return passDirFilter();
+
+        case AFS::ItemType::symlink:
+            switch (cfg_.handleSymlinks)
+            {
+                case SymLinkHandling::exclude:
+                    return false;
+                case SymLinkHandling::direct:
+                    return passFileFilter(); //see onSymlink()
+                case SymLinkHandling::follow:
+                    return passFileFilter() || passDirFilter(); //target type not yet known
+            }
+            break;
+    }
+    assert(false);
+    return true;
+}
+
+
 std::shared_ptr<AFS::TraverserCallback> DirCallback::onFolder(const AFS::FolderInfo& fi) //throw ThreadStopRequest
 {
     interruptionPoint(); //throw ThreadStopRequest
@@ -319,6 +407,8 @@ std::shared_ptr<AFS::TraverserCallback> DirCallback::onFolder(const AFS::FolderI
     if (cfg_.acb.mayReportCurrentFile(cfg_.threadIdx, cfg_.lastReportTime))
         cfg_.acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_.baseFolderPath, relPath)));
 
+    if (cacheListing_ && !fi.isFollowedSymlink)
+        cacheListing_->folders.push_back(fi);
     //------------------------------------------------------------------------------------
     //apply filter before processing (use relative name!)
     bool childItemMightMatch = true;
@@ -331,6 +421,9 @@ std::shared_ptr<AFS::TraverserCallback> DirCallback::onFolder(const AFS::FolderI
     if (passFilter)
         cfg_.acb.incItemsScanned(); //add 1 element to the progress indicator
 
+    if (!recursive_)
+        return nullptr;
+
     //------------------------------------------------------------------------------------
     if (level_ > FOLDER_TRAVERSAL_LEVEL_MAX) //Win32 traverser: stack overflow approximately at level 1000
         //check after FolderContainer::addSubFolder()
@@ -358,6 +451,9 @@ DirCallback::HandleLink DirCallback::onSymlink(const AFS::SymlinkInfo& si) //thr
     if (cfg_.acb.mayReportCurrentFile(cfg_.threadIdx, cfg_.lastReportTime))
         cfg_.acb.reportCurrentFile(AFS::getDisplayPath(AFS::appendRelPath(cfg_.baseFolderPath, relPath)));
 
+    if (cacheListing_)
+        cacheListing_->symlinks.push_back(si);
+
     switch (cfg_.handleSymlinks)
     {
         case SymLinkHandling::exclude:
@@ -395,6 +491,12 @@ DirCallback::HandleError DirCallback::reportError(const ErrorInfo& errorInfo, co
     switch (handleErr)
     {
         case HandleError::ignore:
+            if (cacheListing_) //folder content is incomplete => don't cache
+            {
+                cfg_.scanCache->newCache.folders.erase(beforeLast(parentRelPathPf_, FILE_NAME_SEPARATOR, IfNotFoundReturn::none));
+                cacheListing_ = nullptr;
+            }
+
             if (itemName.empty())
                 cfg_.failedDirReads.emplace(beforeLast(parentRelPathPf_, FILE_NAME_SEPARATOR, IfNotFoundReturn::none), utfTo<Zstringc>(errorInfo.msg));
             else
@@ -406,10 +508,47 @@ DirCallback::HandleError DirCallback::reportError(const ErrorInfo& errorInfo, co
     }
     return handleErr;
 }
+
+
+const AFS::TraverserCallback::FolderListing* DirCallback::onFolderOpened(const AFS::FolderFingerprint& fp)
+{
+    ScanCacheState& sc = *cfg_.scanCache;
+    const Zstring relPath = beforeLast(parentRelPathPf_, FILE_NAME_SEPARATOR, IfNotFoundReturn::none);
+
+    ScanCacheFolder& newEntry = sc.newCache.folders[relPath];
+    newEntry = {fp, {}}; //called again when retrying after error
+    cacheListing_ = &newEntry.listing;
+
+    if (auto it = sc.oldCache.folders.find(relPath);
+        it != sc.oldCache.folders.end() && isUnchangedFolder(it->second.fingerprint, fp, sc.oldCache.scanStartTimeNs))
+    {
+        switch (sc.mode)
+        {
+            case ScanCacheMode::off:
+                assert(false);
+                break;
+
+            case ScanCacheMode::use:
+                newEntry.listing = std::move(it->second.listing);
+                sc.oldCache.folders.erase(it);
+                cacheListing_ = nullptr; //don't record again while replaying
+                return &newEntry.listing;
+
+            case ScanCacheMode::verify:
+                sc.verifyListings.emplace(relPath, std::move(it->second.listing));
+                sc.oldCache.folders.erase(it);
+                break;
+        }
+    }
+    return nullptr;
+}
 }
 
 
 std::map<DirectoryKey, DirectoryValue> fff::parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
+                                                                    const std::map<DirectoryKey, std::vector<SubFolderRead>>& subFolderReads,
+                                                                    const std::map<AfsDevice, size_t>& deviceParallelOps,
+                                                                    const TravFolderReadCb& onFolderRead,
                                                                     const TravErrorCb& onError, const TravStatusCb& onStatusUpdate,
                                                                     std::chrono::milliseconds cbInterval)
 {
@@ -428,6 +567,7 @@ std::map<DirectoryKey, DirectoryValue> fff::parallelDeviceTraversal(const std::s
     AsyncCallback acb(perDeviceFolders.size() /*threadsToFinish*/, cbInterval); //manage life time: enclose InterruptibleThread's!!!
 
     std::vector<InterruptibleThread> worker;
+    std::vector<const std::set<DirectoryKey>*> workerFolders; //for onFolderRead()
     ZEN_ON_SCOPE_SUCCESS( for (InterruptibleThread& wt : worker) wt.join(); ); //no stop needed in success case => preempt ~InterruptibleThread()
     ZEN_ON_SCOPE_FAIL( for (InterruptibleThread& wt : worker) wt.requestStop(); ); //stop *all* at the same time before join!
 
@@ -435,15 +575,22 @@ std::map<DirectoryKey, DirectoryValue> fff::parallelDeviceTraversal(const std::s
     for (const auto& [afsDevice, dirKeys] : perDeviceFolders)
     {
         const int threadIdx = static_cast<int>(worker.size());
+        workerFolders.push_back(&dirKeys);
         Zstring threadName = Zstr("Comp Device[") + numberTo<Zstring>(threadIdx + 1) + Zstr('/') + numberTo<Zstring>(perDeviceFolders.size()) + Zstr(']');
 
-        const size_t parallelOps = 1;
+        const size_t parallelOps = getDeviceParallelOps(deviceParallelOps, afsDevice);
         std::map<DirectoryKey, DirectoryValue*> workload;
+        std::map<DirectoryKey, std::vector<SubFolderRead>> subReads;
 
         for (const DirectoryKey& key : dirKeys)
+        {
             workload.emplace(key, &output[key]); //=> DirectoryValue* unshared for lock-free worker-thread access
 
-        worker.emplace_back([afsDevice /*clang bug*/= afsDevice, workload, threadIdx, &acb, parallelOps, threadName = std::move(threadName)]() mutable
+            if (auto it = subFolderReads.find(key); it != subFolderReads.end())
+                subReads.emplace(key, it->second);
+        }
+
+        worker.emplace_back([afsDevice /*clang bug*/= afsDevice, workload, subReads, threadIdx, &acb, parallelOps, threadName = std::move(threadName)]() mutable
         {
             setCurrentThreadName(threadName);
 
@@ -452,17 +599,71 @@ std::map<DirectoryKey, DirectoryValue> fff::parallelDeviceTraversal(const std::s
 
             std::chrono::steady_clock::time_point lastReportTime; //keep thread-local!
 
+            std::map<const DirectoryKey*, ScanCacheState> scanCaches;
+
+            for (const auto& [folderKey, folderVal] : workload)
+                if (folderKey.scanCache != ScanCacheMode::off && !subReads.contains(folderKey)) //cache must cover the whole folder
+                    if (std::optional<ScanCacheFile> cacheFile = getScanCacheFile(folderKey.folderPath)) //not supported for (S)FTP, Google Drive, etc.
+                    {
+                        ScanCacheState& sc = scanCaches.emplace(&folderKey, ScanCacheState{folderKey.scanCache, std::move(*cacheFile), {}, {}, {}}).first->second;
+
+                        try { sc.oldCache = loadScanCache(sc.cacheFile); /*throw FileError*/ }
+                        catch (FileError&) {} //not existing, corrupted, old version: it's just a cache => read folders from scratch
+
+                        sc.newCache.baseFolderPath = sc.cacheFile.baseFolderPath;
+                        sc.newCache.scanStartTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+                    }
+
             AFS::TraverserWorkload travWorkload;
 
             for (auto& [folderKey, folderVal] : workload)
             {
                 assert(folderKey.folderPath.afsDevice == afsDevice);
-                travWorkload.emplace_back(folderKey.folderPath.afsPath, std::make_shared<BaseDirCallback>(folderKey, *folderVal, acb, threadIdx, lastReportTime));
+                auto itCache = scanCaches.find(&folderKey);
+
+                if (auto itSub = subReads.find(folderKey); itSub != subReads.end())
+                    for (const SubFolderRead& subRead : itSub->second)
+                    {
+                        FolderContainer* subFolderCont = &folderVal->folderCont;
+                        for (const Zstring& itemName : split(subRead.relPath, FILE_NAME_SEPARATOR, SplitOnEmpty::skip))
+                            if (FolderContainer* subFolderExisting = subFolderCont->findSubFolder(itemName))
+                                subFolderCont = subFolderExisting;
+                            else
+                                subFolderCont = &subFolderCont->addSubFolder(itemName, FolderAttributes(false /*isFollowedSymlink*/));
+
+                        travWorkload.emplace_back(AFS::appendRelPath(folderKey.folderPath, subRead.relPath).afsPath,
+                                                  std::make_shared<BaseDirCallback>(folderKey, *folderVal, acb, threadIdx, lastReportTime, nullptr /*scanCache*/, subRead, *subFolderCont));
+                    }
+                else
+                    travWorkload.emplace_back(folderKey.folderPath.afsPath, std::make_shared<BaseDirCallback>(folderKey, *folderVal, acb, threadIdx, lastReportTime,
+                                                                                                               itCache != scanCaches.end() ? &itCache->second : nullptr,
+                                                                                                               SubFolderRead(), folderVal->folderCont));
             }
             AFS::traverseFolderRecursive(afsDevice, travWorkload, parallelOps); //throw ThreadStopRequest
+
+            for (auto& [folderKey, folderVal] : workload)
+                folderVal->folderCont.removeDuplicates(); //sort + remove items reported twice, e.g. traverser "retry" (still in parallel!)
+
+            for (auto& [folderKey, sc] : scanCaches)
+            {
+                for (const auto& [relPath, listing] : sc.verifyListings)
+                    if (auto it = sc.newCache.folders.find(relPath);
+                        it != sc.newCache.folders.end() && !haveSameContent(listing, it->second.listing))
+                        workload.find(*folderKey)->second->scanCacheMismatches.push_back(relPath);
+
+                if (!sc.newCache.folders.empty()) //=> base folder existing
+                    try { saveScanCache(sc.newCache, sc.cacheFile); /*throw FileError*/ }
+                    catch (FileError&) {} //e.g. config directory not writable: just don't cache
+            }
         });
     }
-    acb.waitUntilDone(cbInterval, onError, onStatusUpdate); //throw X
+    acb.waitUntilDone(cbInterval, onError, onStatusUpdate, [&](int threadIdx) //throw X
+    {
+        //all folders of a device are traversed by the same thread => complete now
+        if (onFolderRead)
+            for (const DirectoryKey& folderKey : *workerFolders[threadIdx])
+                onFolderRead(output.extract(folderKey)); //throw X
+    });
 
     return output;
 }
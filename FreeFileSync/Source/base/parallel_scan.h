@@ -23,6 +23,7 @@ struct DirectoryKey
     AbstractPath folderPath;
     FilterRef filter;
     SymLinkHandling handleSymlinks = SymLinkHandling::exclude;
+    ScanCacheMode scanCache = ScanCacheMode::off;
 
     std::weak_ordering operator<=>(const DirectoryKey&) const = default;
 };
@@ -37,6 +38,17 @@ struct DirectoryValue
 
     //relative paths (never empty) for failure to read single file/dir/symlink
     std::map<Zstring, Zstringc /*error message*/> failedItemReads;
+
+    //ScanCacheMode::verify: relative paths (or empty string for root) for folders with outdated cache content despite unchanged fingerprint
+    std::vector<Zstring> scanCacheMismatches;
+};
+
+
+//read selected sub folders only, e.g. incremental comparison
+struct SubFolderRead
+{
+    Zstring relPath; //empty for base folder; parent folders are added to FolderContainer, but not read
+    bool recursive = true; //false: add sub folders to FolderContainer, but don't read them
 };
 
 
@@ -45,8 +57,13 @@ struct DirectoryValue
 
 using TravErrorCb  = std::function<PhaseCallback::Response(const PhaseCallback::ErrorInfo& errorInfo)>;
 using TravStatusCb = std::function<void (const std::wstring& statusLine, int itemsTotal)>;
+//take ownership of folder content as soon as the folder is read completely (context of main thread) => such folders are not part of the returned map
+using TravFolderReadCb = std::function<void(std::map<DirectoryKey, DirectoryValue>::node_type&& folderNode)>;
 
 std::map<DirectoryKey, DirectoryValue> parallelDeviceTraversal(const std::set<DirectoryKey>& foldersToRead,
+                                                               const std::map<DirectoryKey, std::vector<SubFolderRead>>& subFolderReads, //optional: default is to read the whole folder
+                                                               const std::map<AfsDevice, size_t>& deviceParallelOps,
+                                                               const TravFolderReadCb& onFolderRead, //optional
                                                                const TravErrorCb& onError, const TravStatusCb& onStatusUpdate, //NOT optional
                                                                std::chrono::milliseconds cbInterval);
 }
@@ -6,11 +6,13 @@
 
 #include "path_filter.h"
 #include <set>
+#include <bitset>
 #include <stdexcept>
 #include <vector>
 #include <typeinfo>
 #include <iterator>
 #include <typeindex>
+#include <zen/utf.h>
 
 using namespace zen;
 using namespace fff;
@@ -224,21 +226,152 @@ bool matchesMaskBegin(const Zchar* str, const Zchar* mask)
 }
 
 
-template <class PathEndMatcher> inline
-bool matchesMask(const Zstring& name, const std::vector<Zstring>& masks)
+/*  all masks of a list compiled into a single matcher: same results as std::any_of() + matchesMask<>()/matchesMaskBegin() for each mask, but
+    path chars not matching any mask are rejected in a single pass instead of once per mask (exclude lists with hundreds of masks!)
+
+    - masks starting with literal chars: trie of this literal prefix; the tail (empty or starting with wildcard) is checked at its trie node
+    - masks starting with "*<char>": indexed by <char>; tail is checked at each occurrence of <char> in the path (= same attempts as matchesMask() backtracking)
+    - other masks, e.g. "*", "?abc", "*?abc": tail of the root node     */
+class MaskMatcher
 {
-    return std::any_of(masks.begin(), masks.end(), [&](const Zstring& mask) { return matchesMask<PathEndMatcher>(name.c_str(), mask.c_str()); });
+public:
+    explicit MaskMatcher(const std::vector<Zstring>& masks) : empty_(masks.empty())
+    {
+        for (const Zstring& mask : masks)
+        {
+            const size_t starCount = std::find_if(mask.begin(), mask.end(), [](Zchar c) { return c != Zstr('*'); }) - mask.begin();
+
+            if (starCount > 0 && starCount < mask.size() && mask[starCount] != Zstr('?'))
+                starMasks_.push_back({mask[starCount], Zstring(mask.begin() + starCount + 1, mask.end())});
+            else
+            {
+                const size_t prefixLen = std::find_if(mask.begin(), mask.end(), [](Zchar c) { return c == Zstr('*') || c == Zstr('?'); }) - mask.begin();
+
+                size_t nodeIdx = 0;
+                for (size_t i = 0; i < prefixLen; ++i)
+                    nodeIdx = getOrAddChild(nodeIdx, mask[i]);
+
+                trie_[nodeIdx].tails.emplace_back(mask.begin() + prefixLen, mask.end());
+            }
+        }
+
+        std::sort(starMasks_.begin(), starMasks_.end(), LessStarChar());
+        for (const StarMask& sm : starMasks_)
+            starChars_.set(makeUnsigned(sm.ch));
+    }
+
+    template <class PathEndMatcher>
+    bool matches(const Zstring& path) const
+    {
+        //1. masks starting with literal prefix
+        for (const TrieNode* node = &trie_[0]; node; )
+        {
+            const Zchar* const it = path.c_str() + node->depth;
+
+            if (std::any_of(node->tails.begin(), node->tails.end(), [&](const Zstring& tail) { return matchesMask<PathEndMatcher>(it, tail.c_str()); }))
+                return true;
+
+            node = *it != 0 ? getChild(*node, *it) : nullptr;
+        }
+
+        //2. masks starting with "*<char>"
+        if (!starMasks_.empty())
+            for (const Zchar* it = path.c_str(); *it != 0; ++it)
+                if (starChars_.test(makeUnsigned(*it)))
+                {
+                    auto [itFirst, itLast] = std::equal_range(starMasks_.begin(), starMasks_.end(), StarMask{*it, Zstring()}, LessStarChar());
+                    if (std::any_of(itFirst, itLast, [&](const StarMask& sm) { return matchesMask<PathEndMatcher>(it + 1, sm.tail.c_str()); }))
+                        return true;
+                }
+        return false;
+    }
+
+    //returns true if str matches at least the beginning of any mask
+    bool matchesBegin(const Zstring& str) const
+    {
+        if (!starMasks_.empty()) //"*..." matches any beginning
+            return true;
+
+        for (const TrieNode* node = &trie_[0]; node; )
+        {
+            const Zchar* const it = str.c_str() + node->depth;
+            if (*it == 0) //str is prefix of the literal prefix of all masks below this node (root: any mask)
+                return !empty_;
+
+            if (std::any_of(node->tails.begin(), node->tails.end(), [&](const Zstring& tail) { return matchesMaskBegin(it, tail.c_str()); }))
+                return true;
+
+            node = getChild(*node, *it);
+        }
+        return false;
+    }
+
+private:
+    struct TrieNode
+    {
+        size_t depth = 0; //= length of literal prefix
+        std::vector<std::pair<Zchar, size_t /*node index*/>> children; //sorted by char
+        std::vector<Zstring> tails; //mask remainder after literal prefix: empty or starting with wildcard
+    };
+
+    struct StarMask
+    {
+        Zchar ch; //first char after leading '*'
+        Zstring tail;
+    };
+    struct LessStarChar { bool operator()(const StarMask& lhs, const StarMask& rhs) const { return lhs.ch < rhs.ch; } };
+
+    size_t getOrAddChild(size_t nodeIdx, Zchar ch)
+    {
+        auto& children = trie_[nodeIdx].children;
+        auto it = std::lower_bound(children.begin(), children.end(), ch, [](const auto& child, Zchar c) { return child.first < c; });
+        if (it != children.end() && it->first == ch)
+            return it->second;
+
+        const size_t childIdx = trie_.size();
+        const size_t childDepth = trie_[nodeIdx].depth + 1;
+        children.insert(it, {ch, childIdx});
+        trie_.emplace_back().depth = childDepth; //invalidates "children"!
+        return childIdx;
+    }
+
+    const TrieNode* getChild(const TrieNode& node, Zchar ch) const
+    {
+        auto it = std::lower_bound(node.children.begin(), node.children.end(), ch, [](const auto& child, Zchar c) { return child.first < c; });
+        return it != node.children.end() && it->first == ch ? &trie_[it->second] : nullptr;
+    }
+
+    static_assert(sizeof(Zchar) == 1);
+
+    std::vector<TrieNode> trie_{TrieNode()}; //root node: index 0
+    std::vector<StarMask> starMasks_; //sorted by char
+    std::bitset<256> starChars_;
+    bool empty_;
+};
 }
 
+//#################################################################################################
 
-inline
-bool matchesMaskBegin(const Zstring& name, const std::vector<Zstring>& masks)
+struct NameFilter::CompiledMasks
 {
-    return std::any_of(masks.begin(), masks.end(), [&](const Zstring& mask) { return matchesMaskBegin(name.c_str(), mask.c_str()); });
-}
+    MaskMatcher includeFileFolder;
+    MaskMatcher includeFolder;
+    MaskMatcher excludeFileFolder;
+    MaskMatcher excludeFolder;
+};
+
+
+void NameFilter::compileMasks()
+{
+    compiledMasks_ = std::make_shared<const CompiledMasks>(CompiledMasks
+    {
+        MaskMatcher(includeMasksFileFolder),
+        MaskMatcher(includeMasksFolder),
+        MaskMatcher(excludeMasksFileFolder),
+        MaskMatcher(excludeMasksFolder),
+    });
 }
 
-//#################################################################################################
 
 NameFilter::NameFilter(const Zstring& includePhrase, const Zstring& excludePhrase)
 {
@@ -250,6 +383,8 @@ NameFilter::NameFilter(const Zstring& includePhrase, const Zstring& excludePhras
     removeDuplicates(includeMasksFolder    );
     removeDuplicates(excludeMasksFileFolder);
     removeDuplicates(excludeMasksFolder    );
+
+    compileMasks();
 }
 
 
@@ -259,6 +394,8 @@ void NameFilter::addExclusion(const Zstring& excludePhrase)
 
     removeDuplicates(excludeMasksFileFolder);
     removeDuplicates(excludeMasksFolder    );
+
+    compileMasks();
 }
 
 
@@ -269,12 +406,14 @@ bool NameFilter::passFileFilter(const Zstring& relFilePath) const
     //normalize input: 1. ignore Unicode normalization form 2. ignore case
     const Zstring& pathFmt = getUpperCase(relFilePath);
 
-    if (matchesMask<AnyMatch         >(pathFmt, excludeMasksFileFolder) || //either full match on file or partial match on any parent folder
-        matchesMask<ParentFolderMatch>(pathFmt, excludeMasksFolder)) //partial match on any parent folder only
+    const CompiledMasks& masks = *compiledMasks_;
+
+    if (masks.excludeFileFolder.matches<AnyMatch         >(pathFmt) || //either full match on file or partial match on any parent folder
+        masks.excludeFolder    .matches<ParentFolderMatch>(pathFmt)) //partial match on any parent folder only
         return false;
 
-    return matchesMask<AnyMatch         >(pathFmt, includeMasksFileFolder) ||
-           matchesMask<ParentFolderMatch>(pathFmt, includeMasksFolder);
+    return masks.includeFileFolder.matches<AnyMatch         >(pathFmt) ||
+           masks.includeFolder    .matches<ParentFolderMatch>(pathFmt);
 }
 
 
@@ -286,8 +425,10 @@ bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMa
     //normalize input: 1. ignore Unicode normalization form 2. ignore case
     const Zstring& pathFmt = getUpperCase(relDirPath);
 
-    if (matchesMask<AnyMatch>(pathFmt, excludeMasksFileFolder) ||
-        matchesMask<AnyMatch>(pathFmt, excludeMasksFolder))
+    const CompiledMasks& masks = *compiledMasks_;
+
+    if (masks.excludeFileFolder.matches<AnyMatch>(pathFmt) ||
+        masks.excludeFolder    .matches<AnyMatch>(pathFmt))
     {
         if (childItemMightMatch)
             *childItemMightMatch = false; //perf: no need to traverse deeper; subfolders/subfiles would be excluded by filter anyway!
@@ -304,16 +445,16 @@ bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMa
         return false;
     }
 
-    if (matchesMask<AnyMatch>(pathFmt, includeMasksFileFolder) ||
-        matchesMask<AnyMatch>(pathFmt, includeMasksFolder))
+    if (masks.includeFileFolder.matches<AnyMatch>(pathFmt) ||
+        masks.includeFolder    .matches<AnyMatch>(pathFmt))
         return true;
 
     if (childItemMightMatch)
     {
         const Zstring& childPathBegin = pathFmt + FILE_NAME_SEPARATOR;
 
-        *childItemMightMatch = matchesMaskBegin(childPathBegin, includeMasksFileFolder) || //might match a file  or folder in subdirectory
-                               matchesMaskBegin(childPathBegin, includeMasksFolder );      //
+        *childItemMightMatch = masks.includeFileFolder.matchesBegin(childPathBegin) || //might match a file  or folder in subdirectory
+                               masks.includeFolder    .matchesBegin(childPathBegin);   //
     }
     return false;
 }
@@ -339,6 +480,22 @@ bool NameFilter::isNull() const
 }
 
 
+void NameFilter::addFingerprint(FNV1aHash<uint64_t>& hash) const
+{
+    hash.add(1);
+    for (const std::vector<Zstring>* masks : {&includeMasksFileFolder, &includeMasksFolder, &excludeMasksFileFolder, &excludeMasksFolder})
+    {
+        for (const Zstring& mask : *masks)
+        {
+            for (const char c : utfTo<std::string>(mask))
+                hash.add(static_cast<unsigned char>(c));
+            hash.add(Zstr('|')); //distinguish "ab" from "a", "b"
+        }
+        hash.add(Zstr('\n'));
+    }
+}
+
+
 std::strong_ordering NameFilter::compareSameType(const PathFilter& other) const
 {
     assert(typeid(*this) == typeid(other)); //always given in this context!
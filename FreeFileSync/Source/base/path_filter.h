@@ -45,6 +45,9 @@ public:
 
     virtual FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const = 0;
 
+    //stable across sessions: e.g. stored in sync.ffs_db
+    virtual void addFingerprint(zen::FNV1aHash<uint64_t>& hash) const = 0;
+
 private:
     friend std::strong_ordering operator<=>(const FilterRef& lhs, const FilterRef& rhs);
 
@@ -63,6 +66,7 @@ public:
     bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override;
     bool isNull() const override { return true; }
     FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const override;
+    void addFingerprint(zen::FNV1aHash<uint64_t>& hash) const override { hash.add(0); }
 
 private:
     std::strong_ordering compareSameType(const PathFilter& other) const override { assert(typeid(*this) == typeid(other)); return std::strong_ordering::equal; }
@@ -82,16 +86,22 @@ public:
     bool isNull() const override;
     static bool isNull(const Zstring& includePhrase, const Zstring& excludePhrase); //*fast* check without expensive NameFilter construction!
     FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const override;
+    void addFingerprint(zen::FNV1aHash<uint64_t>& hash) const override;
 
 private:
     friend class CombinedFilter;
     std::strong_ordering compareSameType(const PathFilter& other) const override;
 
+    void compileMasks();
+
     //upper-case + Unicode-normalized by construction:
     std::vector<Zstring> includeMasksFileFolder;
     std::vector<Zstring> includeMasksFolder;
     std::vector<Zstring> excludeMasksFileFolder;
     std::vector<Zstring> excludeMasksFolder;
+
+    struct CompiledMasks;
+    std::shared_ptr<const CompiledMasks> compiledMasks_; //evaluate all masks above in a single pass; immutable => shared by NameFilter copies
 };
 
 
@@ -104,6 +114,7 @@ public:
     bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override;
     bool isNull() const override;
     FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const override;
+    void addFingerprint(zen::FNV1aHash<uint64_t>& hash) const override { first_.addFingerprint(hash); second_.addFingerprint(hash); }
 
 private:
     std::strong_ordering compareSameType(const PathFilter& other) const override;
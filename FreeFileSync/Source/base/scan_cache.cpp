@@ -0,0 +1,239 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "scan_cache.h"
+#include <bit> //std::endian
+#include <cstdlib> //realpath
+#include <zen/crc.h>
+#include <zen/file_io.h>
+#include <zen/file_access.h>
+#include <zen/scope_guard.h>
+#include <zen/zlib_wrap.h>
+#include "../afs/native.h"
+#include "../ffs_paths.h"
+
+using namespace zen;
+using namespace fff;
+
+
+namespace
+{
+//-------------------------------------------------------------------------------------------------------------------------------
+const char SCAN_CACHE_FILE_DESCR[] = "FreeFileSync Scan";
+const int SCAN_CACHE_FILE_VERSION = 2; //2026-10-16: moved from base folder to config directory
+//-------------------------------------------------------------------------------------------------------------------------------
+
+/*------------------------------------------------------------------------------
+  | ensure 32/64 bit portability: use fixed size data types only e.g. uint32_t |
+  ------------------------------------------------------------------------------*/
+
+void writeItemName(MemoryStreamOut<std::string>& stream, const Zstring& itemName) { writeContainer(stream, utfTo<std::string>(itemName)); }
+Zstring readItemName(MemoryStreamIn<std::string>& stream) { return utfTo<Zstring>(readContainer<std::string>(stream)); } //throw SysErrorUnexpectedEos
+
+
+void writeListing(MemoryStreamOut<std::string>& stream, const AFS::TraverserCallback::FolderListing& listing)
+{
+    writeNumber<uint32_t>(stream, static_cast<uint32_t>(listing.files.size()));
+    for (const AFS::FileInfo& fi : listing.files)
+    {
+        writeItemName(stream, fi.itemName);
+        writeNumber<uint64_t        >(stream, fi.fileSize);
+        writeNumber<int64_t         >(stream, fi.modTime);
+        writeNumber<AFS::FingerPrint>(stream, fi.filePrint);
+    }
+
+    writeNumber<uint32_t>(stream, static_cast<uint32_t>(listing.folders.size()));
+    for (const AFS::FolderInfo& fi : listing.folders)
+        writeItemName(stream, fi.itemName);
+
+    writeNumber<uint32_t>(stream, static_cast<uint32_t>(listing.symlinks.size()));
+    for (const AFS::SymlinkInfo& si : listing.symlinks)
+    {
+        writeItemName(stream, si.itemName);
+        writeNumber<int64_t>(stream, si.modTime);
+    }
+}
+
+
+AFS::TraverserCallback::FolderListing readListing(MemoryStreamIn<std::string>& stream) //throw SysErrorUnexpectedEos
+{
+    AFS::TraverserCallback::FolderListing listing;
+
+    size_t fileCount = readNumber<uint32_t>(stream);
+    while (fileCount-- != 0)
+    {
+        Zstring itemName = readItemName(stream);
+        const uint64_t         fileSize  = readNumber<uint64_t        >(stream);
+        const int64_t          modTime   = readNumber<int64_t         >(stream);
+        const AFS::FingerPrint filePrint = readNumber<AFS::FingerPrint>(stream);
+        listing.files.push_back({std::move(itemName), fileSize, static_cast<time_t>(modTime), filePrint, false /*isFollowedSymlink*/});
+    }
+
+    size_t folderCount = readNumber<uint32_t>(stream);
+    while (folderCount-- != 0)
+        listing.folders.push_back({readItemName(stream), false /*isFollowedSymlink*/});
+
+    size_t symlinkCount = readNumber<uint32_t>(stream);
+    while (symlinkCount-- != 0)
+    {
+        Zstring itemName = readItemName(stream);
+        const int64_t modTime = readNumber<int64_t>(stream);
+        listing.symlinks.push_back({std::move(itemName), static_cast<time_t>(modTime)});
+    }
+    return listing;
+}
+
+
+template <class Item, class Less>
+bool haveSameItems(std::vector<Item> lhs, std::vector<Item> rhs, Less less)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+
+    std::sort(lhs.begin(), lhs.end(), less);
+    std::sort(rhs.begin(), rhs.end(), less);
+
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), [&](const Item& l, const Item& r) { return !less(l, r) && !less(r, l); });
+}
+}
+
+
+bool fff::isUnchangedFolder(const AFS::FolderFingerprint& fpCached, const AFS::FolderFingerprint& fpCurrent, int64_t cacheScanStartTimeNs)
+{
+    if (fpCached != fpCurrent)
+        return false;
+
+    //"racy" folder: modified shortly before/during the scan that cached it => later changes might not update the (coarse) mod time
+    return fpCurrent.modTimeNs < cacheScanStartTimeNs - std::chrono::nanoseconds(SCAN_CACHE_RACY_WINDOW).count();
+}
+
+
+bool fff::haveSameContent(const AFS::TraverserCallback::FolderListing& lhs, const AFS::TraverserCallback::FolderListing& rhs)
+{
+    //traversal order is file system-dependent and not necessarily stable
+    return haveSameItems(lhs.files, rhs.files, [](const AFS::FileInfo& l, const AFS::FileInfo& r)
+    { return std::tie(l.itemName, l.fileSize, l.modTime, l.filePrint) < std::tie(r.itemName, r.fileSize, r.modTime, r.filePrint); }) &&
+
+    haveSameItems(lhs.folders, rhs.folders, [](const AFS::FolderInfo& l, const AFS::FolderInfo& r)
+    { return l.itemName < r.itemName; }) &&
+
+    haveSameItems(lhs.symlinks, rhs.symlinks, [](const AFS::SymlinkInfo& l, const AFS::SymlinkInfo& r)
+    { return std::tie(l.itemName, l.modTime) < std::tie(r.itemName, r.modTime); });
+}
+
+
+std::optional<ScanCacheFile> fff::getScanCacheFile(const AbstractPath& baseFolderPath)
+{
+    static_assert(std::endian::native == std::endian::little); //see getDatabaseFilePath()
+
+    const Zstring baseFolderPathNative = getNativeItemPath(baseFolderPath);
+    if (baseFolderPathNative.empty())
+        return {};
+
+    char* resolvedPath = ::realpath(baseFolderPathNative.c_str(), nullptr);
+    if (!resolvedPath)
+        return {}; //base folder not existing (yet): nothing to cache
+    ZEN_ON_SCOPE_EXIT(::free(resolvedPath));
+
+    ScanCacheFile cacheFile;
+    cacheFile.baseFolderPath = resolvedPath;
+    cacheFile.filePath = getConfigDirPathPf() + Zstr("ScanCache") + FILE_NAME_SEPARATOR +
+                         printNumber<Zstring>(Zstr("%08x"), static_cast<unsigned int>(getCrc32(utfTo<std::string>(cacheFile.baseFolderPath)))) + SCAN_CACHE_FILE_ENDING;
+    return cacheFile;
+}
+
+
+ScanCache fff::loadScanCache(const ScanCacheFile& cacheFile) //throw FileError
+{
+    const Zstring& filePath = cacheFile.filePath;
+    const std::string byteStream = getFileContent(filePath, nullptr /*notifyUnbufferedIO*/); //throw FileError
+    try
+    {
+        MemoryStreamIn<std::string> memStreamIn(byteStream);
+
+        char formatDescr[sizeof(SCAN_CACHE_FILE_DESCR)] = {};
+        readArray(memStreamIn, formatDescr, sizeof(formatDescr)); //throw SysErrorUnexpectedEos
+
+        if (!std::equal(SCAN_CACHE_FILE_DESCR, SCAN_CACHE_FILE_DESCR + sizeof(SCAN_CACHE_FILE_DESCR), formatDescr))
+            throw SysError(_("File content is corrupted.") + L" (invalid header)");
+
+        const int version = readNumber<int32_t>(memStreamIn); //throw SysErrorUnexpectedEos
+        if (version != SCAN_CACHE_FILE_VERSION) //no migration: it's just a cache
+            throw SysError(_("Unsupported data format.") + L' ' + replaceCpy(_("Version: %x"), L"%x", numberTo<std::wstring>(version)));
+
+        //a corrupted cache is worse than none: check *before* trusting any of it
+        assert(byteStream.size() >= sizeof(uint32_t));
+        MemoryStreamOut<std::string> crcStreamOut;
+        writeNumber<uint32_t>(crcStreamOut, getCrc32(byteStream.begin(), byteStream.end() - sizeof(uint32_t)));
+
+        if (!endsWith(byteStream, crcStreamOut.ref()))
+            throw SysError(_("File content is corrupted.") + L" (invalid checksum)");
+
+        const std::string rawStream = decompress(readContainer<std::string>(memStreamIn)); //throw SysError, SysErrorUnexpectedEos
+        MemoryStreamIn<std::string> streamIn(rawStream);
+
+        ScanCache cache;
+        cache.baseFolderPath = readItemName(streamIn); //throw SysErrorUnexpectedEos
+        if (cache.baseFolderPath != cacheFile.baseFolderPath) //hash collision: cache file belongs to a different base folder
+            throw SysError(replaceCpy<std::wstring>(L"Cache file belongs to base folder %x.", L"%x", fmtPath(cache.baseFolderPath)));
+
+        cache.scanStartTimeNs = readNumber<int64_t>(streamIn); //throw SysErrorUnexpectedEos
+
+        size_t folderCount = readNumber<uint32_t>(streamIn); //throw SysErrorUnexpectedEos
+        while (folderCount-- != 0)
+        {
+            Zstring relPath = readItemName(streamIn); //throw SysErrorUnexpectedEos
+
+            ScanCacheFolder& folder = cache.folders[std::move(relPath)];
+            folder.fingerprint.modTimeNs   = readNumber<int64_t         >(streamIn); //throw SysErrorUnexpectedEos
+            folder.fingerprint.folderPrint = readNumber<AFS::FingerPrint>(streamIn); //
+            folder.listing = readListing(streamIn); //throw SysErrorUnexpectedEos
+        }
+        return cache;
+    }
+    catch (const SysError& e)
+    {
+        throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(filePath)), e.toString());
+    }
+}
+
+
+void fff::saveScanCache(const ScanCache& cache, const ScanCacheFile& cacheFile) //throw FileError
+{
+    const Zstring& filePath = cacheFile.filePath;
+    assert(cache.baseFolderPath == cacheFile.baseFolderPath);
+
+    MemoryStreamOut<std::string> streamOut;
+    writeItemName(streamOut, cacheFile.baseFolderPath);
+    writeNumber<int64_t>(streamOut, cache.scanStartTimeNs);
+
+    writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(cache.folders.size()));
+    for (const auto& [relPath, folder] : cache.folders)
+    {
+        writeItemName(streamOut, relPath);
+        writeNumber<int64_t         >(streamOut, folder.fingerprint.modTimeNs);
+        writeNumber<AFS::FingerPrint>(streamOut, folder.fingerprint.folderPrint);
+        writeListing(streamOut, folder.listing);
+    }
+
+    MemoryStreamOut<std::string> memStreamOut;
+    writeArray(memStreamOut, SCAN_CACHE_FILE_DESCR, sizeof(SCAN_CACHE_FILE_DESCR));
+    writeNumber<int32_t>(memStreamOut, SCAN_CACHE_FILE_VERSION);
+    try
+    {
+        writeContainer(memStreamOut, compress(streamOut.ref(), 3 /*level*/)); //throw SysError; see db_file.cpp for level rationale
+    }
+    catch (const SysError& e)
+    {
+        throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(filePath)), e.toString());
+    }
+    writeNumber<uint32_t>(memStreamOut, getCrc32(memStreamOut.ref()));
+
+    if (const std::optional<Zstring> parentPath = getParentFolderPath(filePath))
+        createDirectoryIfMissingRecursion(*parentPath); //throw FileError
+
+    setFileContent(filePath, memStreamOut.ref(), nullptr /*notifyUnbufferedIO*/); //throw FileError
+}
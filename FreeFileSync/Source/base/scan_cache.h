@@ -0,0 +1,70 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef SCAN_CACHE_H_4738209571092384756
+#define SCAN_CACHE_H_4738209571092384756
+
+#include <map>
+#include <optional>
+#include <zen/file_error.h>
+#include "structures.h"
+
+
+namespace fff
+{
+/* Persistent folder content cache: reuse the (unfiltered) content of unchanged folders instead of reading them again
+    - stored in config directory: ScanCache/<hash of base folder path>.ffs_scan
+        => comparison must NOT write to base folders: may be read-only, and base folder modification time would change with every cache update
+    - native file system only: requires folder fingerprints, see AFS::TraverserCallback::onFolderOpened()
+
+   A cached folder listing is reused only if:
+    1. modification time (nanosecond precision) and file ID (inode) of the folder are unchanged
+    2. the folder was last modified at least SCAN_CACHE_RACY_WINDOW before the scan that cached it: coarse time stamps
+       (FAT: 2 sec, ext3: 1 sec) may not reflect a change made shortly after the folder was read
+    3. the folder was read without errors (including item-level errors)
+   Filter and symlink settings are irrelevant: the cache holds the unfiltered folder content.
+
+   CAVEAT: folder modification time changes when items are added, removed or renamed, but NOT when a file is modified in place!
+    => ScanCacheMode::use is only safe if files are replaced atomically (write temp file + rename), e.g. backup and archive folders
+    => also unreliable: file systems that don't update folder times, e.g. some SMB and FUSE implementations
+    => ScanCacheMode::verify: read all folders as usual, but report folders whose cached content *would* have been reused,
+       although it is outdated => run in verify mode first (and periodically) to check if the cache can be trusted        */
+
+const Zchar SCAN_CACHE_FILE_ENDING[] = Zstr(".ffs_scan"); //don't use Zstring as global constant: avoid static initialization order problem in global namespace!
+
+constexpr std::chrono::seconds SCAN_CACHE_RACY_WINDOW(2);
+
+
+struct ScanCacheFolder
+{
+    AFS::FolderFingerprint fingerprint;
+    AFS::TraverserCallback::FolderListing listing;
+};
+
+struct ScanCache
+{
+    Zstring baseFolderPath;      //native path, symlinks resolved: detect hash collisions of cache file names
+    int64_t scanStartTimeNs = 0; //nanoseconds since Jan. 1st 1970 UTC
+    std::map<Zstring, ScanCacheFolder> folders; //key: folder path relative to base folder, empty for base folder
+};
+
+bool isUnchangedFolder(const AFS::FolderFingerprint& fpCached, const AFS::FolderFingerprint& fpCurrent, int64_t cacheScanStartTimeNs);
+
+bool haveSameContent(const AFS::TraverserCallback::FolderListing& lhs, const AFS::TraverserCallback::FolderListing& rhs);
+
+struct ScanCacheFile
+{
+    Zstring baseFolderPath; //native path, symlinks resolved: same cache for all aliases of a base folder
+    Zstring filePath;       //within config directory
+};
+//nullopt if not supported (not a native folder) or base folder not existing
+std::optional<ScanCacheFile> getScanCacheFile(const AbstractPath& baseFolderPath);
+
+ScanCache loadScanCache(const ScanCacheFile& cacheFile); //throw FileError
+void      saveScanCache(const ScanCache& cache, const ScanCacheFile& cacheFile); //throw FileError
+}
+
+#endif //SCAN_CACHE_H_4738209571092384756
@@ -19,6 +19,7 @@ Semantics of SoftFilter:
 1. It potentially may match only one side => it MUST NOT be applied while traversing a single folder to avoid mismatches
 2. => it is applied after traversing and just marks rows, (NO deletions after comparison are allowed)
 3. => equivalent to a user temporarily (de-)selecting rows => not relevant for <two way>-mode!
+4. opt-in: MainConfiguration::pruneSoftFiltered drops rows excluded on *both* sides while merging the two sides (see comparison.cpp)
 */
 
 class SoftFilter
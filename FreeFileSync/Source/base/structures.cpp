@@ -27,6 +27,7 @@ std::wstring fff::getVariantName(std::optional<CompareVariant> var)
         case CompareVariant::timeSize: return _("File time and size");
         case CompareVariant::content:  return _("File content");
         case CompareVariant::size:     return _("File size");
+        case CompareVariant::hash:     return _("File content (hash)");
         //*INDENT-ON*
     }
     assert(false);
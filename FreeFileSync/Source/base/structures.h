@@ -22,7 +22,8 @@ enum class CompareVariant
 {
     timeSize,
     content,
-    size
+    size,
+    hash, //like "content", but both sides are read independently
 };
 
 
@@ -49,7 +50,7 @@ enum CompareFileResult
     FILE_RIGHT_SIDE_ONLY,
     FILE_LEFT_NEWER,  //CompareVariant::timeSize only!
     FILE_RIGHT_NEWER, //
-    FILE_DIFFERENT_CONTENT, //CompareVariant::content, CompareVariant::size only!
+    FILE_DIFFERENT_CONTENT, //CompareVariant::content, CompareVariant::hash, CompareVariant::size only!
     FILE_DIFFERENT_METADATA, //both sides equal, but different metadata only: short name case
     FILE_CONFLICT
 };
@@ -111,7 +112,7 @@ struct DirectionSet
     SyncDirection exRightSideOnly = SyncDirection::left;
     SyncDirection leftNewer       = SyncDirection::right; //CompareVariant::timeSize only!
     SyncDirection rightNewer      = SyncDirection::left;  //
-    SyncDirection different       = SyncDirection::none; //CompareVariant::content, CompareVariant::size only!
+    SyncDirection different       = SyncDirection::none; //CompareVariant::content, CompareVariant::hash, CompareVariant::size only!
     SyncDirection conflict        = SyncDirection::none;
 
     bool operator==(const DirectionSet&) const = default;
@@ -359,6 +360,14 @@ enum class PostSyncCondition
 };
 
 
+enum class ScanCacheMode //see scan_cache.h
+{
+    off,
+    use,
+    verify
+};
+
+
 struct MainConfiguration
 {
     CompConfig   cmpCfg;       //global compare settings:         may be overwritten by folder pair settings
@@ -370,6 +379,13 @@ struct MainConfiguration
 
     std::map<AfsDevice, size_t /*parallel operations*/> deviceParallelOps; //should only include devices with >= 2  parallel ops
 
+    ScanCacheMode scanCache = ScanCacheMode::off; //opt-in: reuse content of unchanged folders from last scan
+
+    /* opt-in: drop items excluded by time/size filter on *both* sides while generating the file list, instead of keeping them as inactive rows
+        => less memory and no (content) comparison for them, but a loosened soft filter needs a new comparison to show them
+        => ignored if sync.ffs_db is used (two way, detect moved files): excluded items must preserve their last synchronous state */
+    bool pruneSoftFiltered = false;
+
     bool ignoreErrors = false; //true: errors will still be logged
     size_t autoRetryCount = 0;
     std::chrono::seconds autoRetryDelay{5};
@@ -6,6 +6,7 @@
 
 #include "synchronization.h"
 #include <tuple>
+#include <list>
 #include <zen/process_priority.h>
 #include <zen/perf.h>
 #include <zen/guid.h>
@@ -374,20 +375,27 @@ std::vector<FolderPairSyncCfg> fff::extractSyncCfg(const MainConfiguration& main
 
     for (const LocalPairConfig& lpc : localCfgs)
     {
-        //const CompConfig cmpCfg  = lpc.localCmpCfg  ? *lpc.localCmpCfg  : mainCfg.cmpCfg;
+        const CompConfig cmpCfg  = lpc.localCmpCfg  ? *lpc.localCmpCfg  : mainCfg.cmpCfg;
         const SyncConfig syncCfg = lpc.localSyncCfg ? *lpc.localSyncCfg : mainCfg.syncCfg;
 
+        size_t threadCount = std::max(getDeviceParallelOps(mainCfg.deviceParallelOps, lpc.folderPathPhraseLeft),
+                                      getDeviceParallelOps(mainCfg.deviceParallelOps, lpc.folderPathPhraseRight));
+        if (syncCfg.handleDeletion == DeletionPolicy::versioning)
+            threadCount = std::max(threadCount, getDeviceParallelOps(mainCfg.deviceParallelOps, syncCfg.versioningFolderPhrase));
+
         output.push_back(
         {
             syncCfg.directionCfg.var,
             syncCfg.directionCfg.var == SyncVariant::twoWay || detectMovedFilesEnabled(syncCfg.directionCfg),
+            cmpCfg.handleSymlinks,
 
             syncCfg.handleDeletion,
             syncCfg.versioningFolderPhrase,
             syncCfg.versioningStyle,
             syncCfg.versionMaxAgeDays,
             syncCfg.versionCountMin,
-            syncCfg.versionCountMax
+            syncCfg.versionCountMax,
+            threadCount
         });
     }
     return output;
@@ -471,7 +479,7 @@ void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath,
             !targetPathNative.empty())
             flushFileBuffers(targetPathNative); //throw FileError
 
-        if (!filesHaveSameContent(sourcePath, targetPath, notifyUnbufferedIO)) //throw FileError, X
+        if (!filesHaveSameContent(sourcePath, targetPath, notifyUnbufferedIO, nullptr /*contentHash*/)) //throw FileError, X
             throw FileError(replaceCpy(replaceCpy(_("%x and %y have different content."),
                                                   L"%x", L'\n' + fmtPath(AFS::getDisplayPath(sourcePath))),
                                        L"%y", L'\n' + fmtPath(AFS::getDisplayPath(targetPath))));
@@ -822,7 +830,7 @@ void DeletionHandler::removeLinkWithCallback(const AbstractPath& linkPath, //thr
 class Workload
 {
 public:
-    Workload(size_t threadCount, AsyncCallback& acb) : acb_(acb), workload_(threadCount) { assert(threadCount > 0); }
+    Workload(size_t threadCount, const std::function<void()>& notifyAllDone /*noexcept*/) : notifyAllDone_(notifyAllDone), workload_(threadCount) { assert(threadCount > 0); }
 
     using WorkItem  = std::function<void() /*throw ThreadStopRequest*/>;
     using WorkItems = RingBuffer<WorkItem>; //FIFO!
@@ -867,7 +875,7 @@ public:
                 else //wait...
                 {
                     if (++idleThreads_ == workload_.size())
-                        acb_.notifyAllDone(); //noexcept
+                        notifyAllDone_(); //noexcept
                     ZEN_ON_SCOPE_EXIT(--idleThreads_);
 
                     auto haveNewWork = [&] { return !pendingWorkload_.empty() || std::any_of(workload_.begin(), workload_.end(), [](const WorkItems& wi) { return !wi.empty(); }); };
@@ -896,7 +904,7 @@ private:
     Workload           (const Workload&) = delete;
     Workload& operator=(const Workload&) = delete;
 
-    AsyncCallback& acb_;
+    const std::function<void()> notifyAllDone_; //noexcept
 
     std::mutex lockWork_;
     std::condition_variable conditionNewWork_;
@@ -921,19 +929,22 @@ class FolderPairSyncer
 public:
     struct SyncCtx
     {
+        BaseFolderPair& baseFolder;
         bool verifyCopiedFiles;
         bool copyFilePermissions;
         bool failSafeFileCopy;
         std::vector<FileError>& errorsModTime;
         DeletionHandler& delHandlerLeft;
         DeletionHandler& delHandlerRight;
+        size_t threadCount;
     };
 
-    static void runSync(SyncCtx& syncCtx, BaseFolderPair& baseFolder, PhaseCallback& cb)
+    //CONTRACT: folder pairs are synchronized concurrently => must not share devices!
+    static void runSync(std::span<SyncCtx> syncCtxs, PhaseCallback& cb)
     {
-        runPass(PassNo::zero, syncCtx, baseFolder, cb); //prepare file moves
-        runPass(PassNo::one,  syncCtx, baseFolder, cb); //delete files (or overwrite big ones with smaller ones)
-        runPass(PassNo::two,  syncCtx, baseFolder, cb); //copy rest
+        runPass(PassNo::zero, syncCtxs, cb); //prepare file moves
+        runPass(PassNo::one,  syncCtxs, cb); //delete files (or overwrite big ones with smaller ones)
+        runPass(PassNo::two,  syncCtxs, cb); //copy rest
     }
 
 private:
@@ -963,7 +974,7 @@ private:
     static bool needZeroPass(const FilePair& file);
     static bool needZeroPass(const FolderPair& folder);
 
-    static void runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& baseFolder, PhaseCallback& cb); //throw X
+    static void runPass(PassNo pass, std::span<SyncCtx> syncCtxs, PhaseCallback& cb); //throw X
 
     RingBuffer<Workload::WorkItems> getFolderLevelWorkItems(PassNo pass, ContainerObject& parentFolder, Workload& workload);
 
@@ -1039,40 +1050,73 @@ Callback     =============       --------------------
                                  |     Workload     |
                                  --------------------
 
-Notes: - All threads share a single mutex, unlocked only during file I/O => do NOT require file_hierarchy.cpp classes to be thread-safe (i.e. internally synchronized)!
+Notes: - All threads of a folder pair share a single mutex, unlocked only during file I/O => do NOT require file_hierarchy.cpp classes to be thread-safe (i.e. internally synchronized)!
+       - Folder pairs without shared devices run concurrently: each with its own mutex, Workload and threads, all reporting via the same AsyncCallback
        - Workload holds (folder-level-) items in buckets associated with each worker thread (FTP scenario: avoid CWDs)
        - If a worker is idle, its Workload bucket is empty and no more pending buckets available: steal from other threads (=> take half of largest bucket)
        - Maximize opportunity for parallelization ASAP: Workload buckets serve folder-items *before* files/symlinks => reduce risk of work-stealing
        - Memory consumption: work items may grow indefinitely; however: test case "C:\" ~80MB per 1 million work items
 */
 
-void FolderPairSyncer::runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& baseFolder, PhaseCallback& cb) //throw X
+void FolderPairSyncer::runPass(PassNo pass, std::span<SyncCtx> syncCtxs, PhaseCallback& cb) //throw X
 {
-    std::mutex singleThread; //only a single worker thread may run at a time, except for parallel file I/O
+    if (syncCtxs.empty())
+        return; //[!] otherwise AsyncCallback::notifyAllDone() is never called!
+
+    AsyncCallback acb;                                          //
+    std::atomic<size_t> activeFolderPairCount(syncCtxs.size()); //manage life time: enclose InterruptibleThread's!!!
 
-    AsyncCallback acb;                                //
-    FolderPairSyncer fps(syncCtx, singleThread, acb); //manage life time: enclose InterruptibleThread's!!!
-    Workload workload(1, acb);
-    workload.addWorkItems(fps.getFolderLevelWorkItems(pass, baseFolder, workload)); //initial workload: set *before* threads get access!
+    struct FolderPairWorkload
+    {
+        FolderPairWorkload(SyncCtx& syncCtx, AsyncCallback& acb, std::atomic<size_t>& activeFolderPairCount) :
+            fps(syncCtx, singleThread, acb),
+            workload(std::max<size_t>(syncCtx.threadCount, 1), [&acb, &activeFolderPairCount]
+        {
+            if (--activeFolderPairCount == 0)
+                acb.notifyAllDone(); //noexcept
+        }) {}
+
+        std::mutex singleThread; //only a single worker thread may run at a time, except for parallel file I/O
+        FolderPairSyncer fps;
+        Workload workload;
+    };
+    std::vector<std::unique_ptr<FolderPairWorkload>> fpWorkloads; //
+
+    for (SyncCtx& syncCtx : syncCtxs)
+    {
+        FolderPairWorkload& fpw = *fpWorkloads.emplace_back(std::make_unique<FolderPairWorkload>(syncCtx, acb, activeFolderPairCount));
+        fpw.workload.addWorkItems(fpw.fps.getFolderLevelWorkItems(pass, syncCtx.baseFolder, fpw.workload)); //initial workload: set *before* threads get access!
+    }
 
     std::vector<InterruptibleThread> worker;
     ZEN_ON_SCOPE_EXIT( for (InterruptibleThread& wt : worker) wt.requestStop(); ); //stop *all* at the same time before join!
 
-    size_t threadIdx = 0;
-    Zstring threadName = Zstr("Sync Worker");
-        worker.emplace_back([threadIdx, &singleThread, &acb, &workload, threadName = std::move(threadName)]
+    for (size_t fpIdx = 0; fpIdx < syncCtxs.size(); ++fpIdx)
+    {
+        FolderPairWorkload& fpw = *fpWorkloads[fpIdx];
+        const size_t threadCount = std::max<size_t>(syncCtxs[fpIdx].threadCount, 1);
+
+        for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
         {
-            setCurrentThreadName(threadName);
+            Zstring threadName = Zstr("Sync Worker[") + numberTo<Zstring>(threadIdx + 1) + Zstr('/') + numberTo<Zstring>(threadCount) + Zstr(']');
+            if (syncCtxs.size() > 1)
+                threadName += Zstr(" Pair[") + numberTo<Zstring>(fpIdx + 1) + Zstr('/') + numberTo<Zstring>(syncCtxs.size()) + Zstr(']');
 
-            while (/*blocking call:*/ std::function<void()> workItem = workload.getNext(threadIdx)) //throw ThreadStopRequest
+            worker.emplace_back([threadIdx, &fpw, &acb, threadName = std::move(threadName)]
             {
-                acb.notifyTaskBegin(0 /*prio*/); //same prio, while processing only one folder pair at a time
-                ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
+                setCurrentThreadName(threadName);
 
-                std::lock_guard dummy(singleThread); //protect ALL accesses to "fps" and workItem execution!
-                workItem(); //throw ThreadStopRequest
-            }
-        });
+                while (/*blocking call:*/ std::function<void()> workItem = fpw.workload.getNext(threadIdx)) //throw ThreadStopRequest
+                {
+                    acb.notifyTaskBegin(threadIdx /*prio*/); //status text: prefer lower thread indexes => less flickering
+                    ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
+
+                    std::lock_guard dummy(fpw.singleThread); //protect ALL accesses to "fps" and workItem execution!
+                    workItem(); //throw ThreadStopRequest
+                }
+            });
+        }
+    }
     acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, cb); //throw X
 }
 
@@ -1524,6 +1568,7 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                             errorsModTime_.push_back(*result.errorModTime); //show all warnings later as a single message
                             break;
                         case CompareVariant::content: //just log, no warning:
+                        case CompareVariant::hash:    //
                         case CompareVariant::size:    //e.g. FTP server not supporting MFMT command
                             acb_.logInfo(result.errorModTime->toString());
                             break;
@@ -1662,6 +1707,7 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                         errorsModTime_.push_back(*result.errorModTime); //show all warnings later as a single message
                         break;
                     case CompareVariant::content: //just log, no warning:
+                    case CompareVariant::hash:    //
                     case CompareVariant::size:    //e.g. FTP server not supporting MFMT command
                         acb_.logInfo(result.errorModTime->toString());
                         break;
@@ -2612,123 +2658,186 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
 
     try
     {
-        //loop through all directory pairs
-        for (auto itBase = begin(folderCmp); itBase != end(folderCmp); ++itBase)
+        //synchronize consecutive folder pairs concurrently if they don't share devices (left, right, versioning)
+        //=> order of folder pairs using the same device is preserved
+        //=> no need to check getPathDependency(): paths on different devices can't depend on each other
+        std::vector<std::vector<size_t /*folderIndex*/>> syncBatches;
         {
-            BaseFolderPair& baseFolder = *itBase;
-            const size_t folderIndex = itBase - begin(folderCmp);
-            const FolderPairSyncCfg& folderPairCfg  = syncConfig     [folderIndex];
-            const SyncStatistics&    folderPairStat = folderPairStats[folderIndex];
+            std::set<AfsDevice> batchDevices;
 
-            if (skipFolderPair[folderIndex]) //folder pairs may be skipped after fatal errors were found
-                continue;
-
-            //------------------------------------------------------------------------------------------
-            if (folderCmp.size() > 1)
-                callback.logInfo(_("Synchronizing folder pair:") + L' ' + getVariantNameWithSymbol(folderPairCfg.syncVar) + L'\n' + //throw X
-                                 L"    " + AFS::getDisplayPath(baseFolder.getAbstractPath<SelectSide::left >()) + L'\n' +
-                                 L"    " + AFS::getDisplayPath(baseFolder.getAbstractPath<SelectSide::right>()));
-            //------------------------------------------------------------------------------------------
+            for (size_t folderIndex = 0; folderIndex < folderCmp.size(); ++folderIndex)
+                if (!skipFolderPair[folderIndex]) //folder pairs may be skipped after fatal errors were found
+                {
+                    const BaseFolderPair& baseFolder = *folderCmp[folderIndex];
+                    const FolderPairSyncCfg& folderPairCfg = syncConfig[folderIndex];
 
-            //checking a second time: 1. a long time may have passed since syncing the previous folder pairs!
-            //                        2. expected to be run directly *before* createBaseFolder()!
-            if (!checkBaseFolderStatus<SelectSide::left >(baseFolder, callback) ||
-                !checkBaseFolderStatus<SelectSide::right>(baseFolder, callback))
-                continue;
+                    std::vector<AbstractPath> folderPaths{baseFolder.getAbstractPath<SelectSide::left >(),
+                                                          baseFolder.getAbstractPath<SelectSide::right>()};
+                    if (folderPairCfg.handleDeletion == DeletionPolicy::versioning)
+                        folderPaths.push_back(createAbstractPath(folderPairCfg.versioningFolderPhrase));
 
-            //create base folders if not yet existing
-            if (folderPairStat.createCount() > 0 || folderPairCfg.saveSyncDB) //else: temporary network drop leading to deletions already caught by "sourceFolderMissing" check!
-                if (!createBaseFolder<SelectSide::left >(baseFolder, copyFilePermissions, callback) || //+ detect temporary network drop!!
-                    !createBaseFolder<SelectSide::right>(baseFolder, copyFilePermissions, callback))   //
-                    continue;
+                    std::set<AfsDevice> devices;
+                    for (const AbstractPath& folderPath : folderPaths)
+                        if (!AFS::isNullPath(folderPath))
+                            devices.insert(folderPath.afsDevice);
 
-            //------------------------------------------------------------------------------------------
-            //execute synchronization recursively
+                    if (syncBatches.empty() ||
+                        std::any_of(devices.begin(), devices.end(), [&](const AfsDevice& afsDevice) { return batchDevices.contains(afsDevice); }))
+                    {
+                        syncBatches.emplace_back();
+                        batchDevices.clear();
+                    }
+                    syncBatches.back().push_back(folderIndex);
+                    batchDevices.insert(devices.begin(), devices.end());
+                }
+        }
 
-            //update database even when sync is cancelled:
-            auto guardDbSave = makeGuard<ScopeGuardRunMode::onFail>([&]
+        for (const std::vector<size_t>& batch : syncBatches)
+        {
+            struct FolderPairJob
             {
-                if (folderPairCfg.saveSyncDB)
-                    saveLastSynchronousState(baseFolder, failSafeFileCopy,
-                                             callbackNoThrow);
-            });
+                FolderPairJob(BaseFolderPair& bf, const FolderPairSyncCfg& fpCfg) : baseFolder(bf), folderPairCfg(fpCfg) {}
+
+                BaseFolderPair& baseFolder;
+                const FolderPairSyncCfg& folderPairCfg;
+                std::optional<DeletionHandler> delHandlerL;
+                std::optional<DeletionHandler> delHandlerR;
+                std::vector<FileError> errorsModTime; //merged after sync: folder pairs may run concurrently
+                bool started        = false; //sync DB must not be updated for folder pairs that were never synchronized
+                bool delCleanupDone = false;
+                bool dbSaveDone     = false;
+            };
+            std::list<FolderPairJob> jobs; //DeletionHandler is not movable
 
             //guarantee removal of invalid entries (where element is empty on both sides)
-            ZEN_ON_SCOPE_EXIT(BaseFolderPair::removeEmpty(baseFolder));
+            ZEN_ON_SCOPE_EXIT(for (FolderPairJob& job : jobs) BaseFolderPair::removeEmpty(job.baseFolder));
 
-            bool copyPermissionsFp = false;
-            tryReportingError([&]
-            {
-                copyPermissionsFp = copyFilePermissions && //copy permissions only if asked for and supported by *both* sides!
-                !AFS::isNullPath(baseFolder.getAbstractPath<SelectSide::left >()) && //scenario: directory selected on one side only
-                !AFS::isNullPath(baseFolder.getAbstractPath<SelectSide::right>()) && //
-                AFS::supportPermissionCopy(baseFolder.getAbstractPath<SelectSide::left>(),
-                                           baseFolder.getAbstractPath<SelectSide::right>()); //throw FileError
-            }, callback); //throw X
+            ZEN_ON_SCOPE_FAIL
+            (
+                for (FolderPairJob& job : jobs)
+                {
+                    //always (try to) clean up, even if synchronization is aborted!
+                    if (!job.delCleanupDone)
+                    {
+                        if (job.delHandlerL) job.delHandlerL->tryCleanup(callbackNoThrow);
+                        if (job.delHandlerR) job.delHandlerR->tryCleanup(callbackNoThrow);
+                    }
+                    //update database even when sync is cancelled:
+                    if (job.folderPairCfg.saveSyncDB && job.started && !job.dbSaveDone)
+                        saveLastSynchronousState(job.baseFolder, job.folderPairCfg.handleSymlinks, failSafeFileCopy,
+                                                 callbackNoThrow);
+                }
+            );
+            ZEN_ON_SCOPE_EXIT(for (FolderPairJob& job : jobs) append(errorsModTime, job.errorsModTime));
 
+            std::vector<FolderPairSyncer::SyncCtx> syncCtxs;
 
-            auto getEffectiveDeletionPolicy = [&](const AbstractPath& baseFolderPath) -> DeletionPolicy
+            for (const size_t folderIndex : batch)
             {
-                if (folderPairCfg.handleDeletion == DeletionPolicy::recycler)
+                BaseFolderPair& baseFolder = *folderCmp[folderIndex];
+                const FolderPairSyncCfg& folderPairCfg  = syncConfig     [folderIndex];
+                const SyncStatistics&    folderPairStat = folderPairStats[folderIndex];
+
+                //------------------------------------------------------------------------------------------
+                if (folderCmp.size() > 1)
+                    callback.logInfo(_("Synchronizing folder pair:") + L' ' + getVariantNameWithSymbol(folderPairCfg.syncVar) + L'\n' + //throw X
+                                     L"    " + AFS::getDisplayPath(baseFolder.getAbstractPath<SelectSide::left >()) + L'\n' +
+                                     L"    " + AFS::getDisplayPath(baseFolder.getAbstractPath<SelectSide::right>()));
+                //------------------------------------------------------------------------------------------
+
+                //checking a second time: 1. a long time may have passed since syncing the previous folder pairs!
+                //                        2. expected to be run directly *before* createBaseFolder()!
+                if (!checkBaseFolderStatus<SelectSide::left >(baseFolder, callback) ||
+                    !checkBaseFolderStatus<SelectSide::right>(baseFolder, callback))
+                    continue;
+
+                //create base folders if not yet existing
+                if (folderPairStat.createCount() > 0 || folderPairCfg.saveSyncDB) //else: temporary network drop leading to deletions already caught by "sourceFolderMissing" check!
+                    if (!createBaseFolder<SelectSide::left >(baseFolder, copyFilePermissions, callback) || //+ detect temporary network drop!!
+                        !createBaseFolder<SelectSide::right>(baseFolder, copyFilePermissions, callback))   //
+                        continue;
+
+                //------------------------------------------------------------------------------------------
+                bool copyPermissionsFp = false;
+                tryReportingError([&]
                 {
-                    auto it = recyclerSupported.find(baseFolderPath);
-                    if (it != recyclerSupported.end()) //buffer filled during intro checks (but only if deletions are expected)
-                        if (!it->second)
-                            return DeletionPolicy::permanent; //Windows' ::SHFileOperation() will do this anyway, but we have a better and faster deletion routine (e.g. on networks)
-                }
-                return folderPairCfg.handleDeletion;
-            };
-            const AbstractPath versioningFolderPath = createAbstractPath(folderPairCfg.versioningFolderPhrase);
+                    copyPermissionsFp = copyFilePermissions && //copy permissions only if asked for and supported by *both* sides!
+                    !AFS::isNullPath(baseFolder.getAbstractPath<SelectSide::left >()) && //scenario: directory selected on one side only
+                    !AFS::isNullPath(baseFolder.getAbstractPath<SelectSide::right>()) && //
+                    AFS::supportPermissionCopy(baseFolder.getAbstractPath<SelectSide::left>(),
+                                               baseFolder.getAbstractPath<SelectSide::right>()); //throw FileError
+                }, callback); //throw X
+
+
+                auto getEffectiveDeletionPolicy = [&](const AbstractPath& baseFolderPath) -> DeletionPolicy
+                {
+                    if (folderPairCfg.handleDeletion == DeletionPolicy::recycler)
+                    {
+                        auto it = recyclerSupported.find(baseFolderPath);
+                        if (it != recyclerSupported.end()) //buffer filled during intro checks (but only if deletions are expected)
+                            if (!it->second)
+                                return DeletionPolicy::permanent; //Windows' ::SHFileOperation() will do this anyway, but we have a better and faster deletion routine (e.g. on networks)
+                    }
+                    return folderPairCfg.handleDeletion;
+                };
+                const AbstractPath versioningFolderPath = createAbstractPath(folderPairCfg.versioningFolderPhrase);
 
-            DeletionHandler delHandlerL(baseFolder.getAbstractPath<SelectSide::left>(),
+                FolderPairJob& job = jobs.emplace_back(baseFolder, folderPairCfg);
+
+                job.delHandlerL.emplace(baseFolder.getAbstractPath<SelectSide::left>(),
                                         getEffectiveDeletionPolicy(baseFolder.getAbstractPath<SelectSide::left>()),
                                         versioningFolderPath,
                                         folderPairCfg.versioningStyle,
                                         std::chrono::system_clock::to_time_t(syncStartTime));
 
-            DeletionHandler delHandlerR(baseFolder.getAbstractPath<SelectSide::right>(),
+                job.delHandlerR.emplace(baseFolder.getAbstractPath<SelectSide::right>(),
                                         getEffectiveDeletionPolicy(baseFolder.getAbstractPath<SelectSide::right>()),
                                         versioningFolderPath,
                                         folderPairCfg.versioningStyle,
                                         std::chrono::system_clock::to_time_t(syncStartTime));
 
-            //always (try to) clean up, even if synchronization is aborted!
-            auto guardDelCleanup = makeGuard<ScopeGuardRunMode::onFail>([&]
-            {
-                delHandlerL.tryCleanup(callbackNoThrow);
-                delHandlerR.tryCleanup(callbackNoThrow);
-            });
-
+                syncCtxs.push_back(
+                {
+                    baseFolder,
+                    verifyCopiedFiles, copyPermissionsFp, failSafeFileCopy,
+                    job.errorsModTime,
+                    *job.delHandlerL, *job.delHandlerR,
+                    folderPairCfg.threadCount,
+                });
+            }
 
-            FolderPairSyncer::SyncCtx syncCtx =
-            {
-                verifyCopiedFiles, copyPermissionsFp, failSafeFileCopy,
-                errorsModTime,
-                delHandlerL, delHandlerR,
-            };
-            FolderPairSyncer::runSync(syncCtx, baseFolder, callback);
+            //------------------------------------------------------------------------------------------
+            //set *before* any worker can modify files: sync DB must be updated if cancelled during runSync()
+            for (FolderPairJob& job : jobs)
+                job.started = true;
 
-            //(try to gracefully) clean up temporary Recycle Bin folders and versioning
-            delHandlerL.tryCleanup(callback); //throw X
-            delHandlerR.tryCleanup(callback); //
-            guardDelCleanup.dismiss();
+            //execute synchronization recursively
+            FolderPairSyncer::runSync(syncCtxs, callback);
 
-            if (folderPairCfg.handleDeletion == DeletionPolicy::versioning &&
-                folderPairCfg.versioningStyle != VersioningStyle::replace)
-                versionLimitFolders.insert(
+            for (FolderPairJob& job : jobs)
             {
-                versioningFolderPath,
-                folderPairCfg.versionMaxAgeDays,
-                folderPairCfg.versionCountMin,
-                folderPairCfg.versionCountMax
-            });
+                //(try to gracefully) clean up temporary Recycle Bin folders and versioning
+                job.delHandlerL->tryCleanup(callback); //throw X
+                job.delHandlerR->tryCleanup(callback); //
+                job.delCleanupDone = true;
+
+                if (job.folderPairCfg.handleDeletion == DeletionPolicy::versioning &&
+                    job.folderPairCfg.versioningStyle != VersioningStyle::replace)
+                    versionLimitFolders.insert(
+                {
+                    createAbstractPath(job.folderPairCfg.versioningFolderPhrase),
+                    job.folderPairCfg.versionMaxAgeDays,
+                    job.folderPairCfg.versionCountMin,
+                    job.folderPairCfg.versionCountMax
+                });
 
-            //(try to gracefully) write database file
-            if (folderPairCfg.saveSyncDB)
-            {
-                saveLastSynchronousState(baseFolder, failSafeFileCopy, //throw X
-                                         callback /*throw X*/);
-                guardDbSave.dismiss(); //[!] after "graceful" try: user might have cancelled during DB write: ensure DB is still written
+                //(try to gracefully) write database file
+                if (job.folderPairCfg.saveSyncDB)
+                {
+                    saveLastSynchronousState(job.baseFolder, job.folderPairCfg.handleSymlinks, failSafeFileCopy, //throw X
+                                             callback /*throw X*/);
+                    job.dbSaveDone = true; //[!] after "graceful" try: user might have cancelled during DB write: ensure DB is still written
+                }
             }
         }
         //-----------------------------------------------------------------------------------------------------
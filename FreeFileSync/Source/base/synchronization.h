@@ -78,12 +78,14 @@ struct FolderPairSyncCfg
 {
     SyncVariant syncVar;
     bool saveSyncDB; //save database if in automatic mode or dection of moved files is active
+    SymLinkHandling handleSymlinks; //recorded in sync.ffs_db
     DeletionPolicy handleDeletion;
     Zstring versioningFolderPhrase; //unresolved directory names as entered by user!
     VersioningStyle versioningStyle;
     int versionMaxAgeDays;
     int versionCountMin;
     int versionCountMax;
+    size_t threadCount; //max. parallel operations of left, right and versioning devices
 };
 std::vector<FolderPairSyncCfg> extractSyncCfg(const MainConfiguration& mainCfg);
 
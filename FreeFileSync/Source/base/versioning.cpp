@@ -340,21 +340,22 @@ void findFileVersions(VersionInfoMap& versions,
         }
     };
 
-    for (const auto& [fileName, attr] : folderCont.files)
-        extractFileVersion(fileName, false /*isSymlink*/);
+    for (const auto& file : folderCont.files)
+        extractFileVersion(file.itemName, false /*isSymlink*/);
 
-    for (const auto& [linkName, attr] : folderCont.symlinks)
-        extractFileVersion(linkName, true /*isSymlink*/);
+    for (const auto& symlink : folderCont.symlinks)
+        extractFileVersion(symlink.itemName, true /*isSymlink*/);
 
-    for (const auto& [folderName, attrAndSub] : folderCont.folders)
+    for (const auto& folder : folderCont.folders)
     {
+        const Zstring& folderName = folder.itemName;
         if (relPathOrigParent.empty() && !versionTimeParent) //VersioningStyle::timestampFolder?
         {
             assert(!versionTimeParent);
             const time_t versionTime = fff::impl::parseVersionedFolderName(folderName);
             if (versionTime != 0)
             {
-                findFileVersions(versions, attrAndSub.second,
+                findFileVersions(versions, folder.value->cont,
                                  AFS::appendRelPath(parentFolderPath, folderName),
                                  Zstring(), //[!] skip time-stamped folder
                                  &versionTime);
@@ -362,7 +363,7 @@ void findFileVersions(VersionInfoMap& versions,
             }
         }
 
-        findFileVersions(versions, attrAndSub.second,
+        findFileVersions(versions, folder.value->cont,
                          AFS::appendRelPath(parentFolderPath, folderName),
                          nativeAppendPaths(relPathOrigParent, folderName),
                          versionTimeParent);
@@ -377,8 +378,8 @@ void getFolderItemCount(std::map<AbstractPath, size_t>& folderItemCount, const F
     //theoretically possible that the same folder is found in one case with items, in another case empty (due to an error)
     //e.g. "subfolder" for versioning folders c:\folder and c:\folder\subfolder
 
-    for (const auto& [folderName, attrAndSub] : folderCont.folders)
-        getFolderItemCount(folderItemCount, attrAndSub.second, AFS::appendRelPath(parentFolderPath, folderName));
+    for (const auto& folder : folderCont.folders)
+        getFolderItemCount(folderItemCount, folder.value->cont, AFS::appendRelPath(parentFolderPath, folder.itemName));
 }
 }
 
@@ -449,7 +450,7 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
         callback.updateStatus(textScanning + statusLine); //throw X
     };
 
-    const std::map<DirectoryKey, DirectoryValue> folderBuf = parallelDeviceTraversal(foldersToRead,
+    const std::map<DirectoryKey, DirectoryValue> folderBuf = parallelDeviceTraversal(foldersToRead, {} /*subFolderReads*/, {} /*deviceParallelOps*/, nullptr /*onFolderRead*/,
     [&](const PhaseCallback::ErrorInfo& errorInfo) { return callback.reportError(errorInfo); }, //throw X
     onStatusUpdate, //throw X
     UI_UPDATE_INTERVAL / 2); //every ~50 ms
@@ -259,6 +259,16 @@ MainConfiguration fff::merge(const std::vector<MainConfiguration>& mainCfgs)
     cfgOut.additionalPairs.assign(mergedCfgs.begin() + 1, mergedCfgs.end());
     cfgOut.deviceParallelOps = mergedParallelOps;
 
+    //scan cache is opt-in: use only if *all* configs agree
+    if (std::any_of(mainCfgs.begin(), mainCfgs.end(), [](const MainConfiguration& mainCfg) { return mainCfg.scanCache == ScanCacheMode::off; }))
+        cfgOut.scanCache = ScanCacheMode::off;
+    else if (std::any_of(mainCfgs.begin(), mainCfgs.end(), [](const MainConfiguration& mainCfg) { return mainCfg.scanCache == ScanCacheMode::verify; }))
+        cfgOut.scanCache = ScanCacheMode::verify;
+    else
+        cfgOut.scanCache = ScanCacheMode::use;
+
+    cfgOut.pruneSoftFiltered = std::all_of(mainCfgs.begin(), mainCfgs.end(), [](const MainConfiguration& mainCfg) { return mainCfg.pruneSoftFiltered; });
+
     cfgOut.ignoreErrors = std::all_of(mainCfgs.begin(), mainCfgs.end(), [](const MainConfiguration& mainCfg) { return mainCfg.ignoreErrors; });
 
     cfgOut.autoRetryCount = std::max_element(mainCfgs.begin(), mainCfgs.end(),
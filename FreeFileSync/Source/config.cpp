@@ -24,7 +24,7 @@ namespace
 {
 //-------------------------------------------------------------------------------------------------------------------------------
 const int XML_FORMAT_GLOBAL_CFG = 22; //2021-07-31
-const int XML_FORMAT_SYNC_CFG   = 17; //2020-10-14
+const int XML_FORMAT_SYNC_CFG   = 19; //2026-10-16
 //-------------------------------------------------------------------------------------------------------------------------------
 }
 
@@ -182,6 +182,9 @@ void writeText(const CompareVariant& value, std::string& output)
         case CompareVariant::size:
             output = "Size";
             break;
+        case CompareVariant::hash:
+            output = "Hash";
+            break;
     }
 }
 
@@ -195,6 +198,8 @@ bool readText(const std::string& input, CompareVariant& value)
         value = CompareVariant::content;
     else if (tmp == "Size")
         value = CompareVariant::size;
+    else if (tmp == "Hash")
+        value = CompareVariant::hash;
     else
         return false;
     return true;
@@ -329,6 +334,39 @@ bool readText(const std::string& input, PostSyncCondition& value)
 }
 
 
+template <> inline
+void writeText(const ScanCacheMode& value, std::string& output)
+{
+    switch (value)
+    {
+        case ScanCacheMode::off:
+            output = "Off";
+            break;
+        case ScanCacheMode::use:
+            output = "Use";
+            break;
+        case ScanCacheMode::verify:
+            output = "Verify";
+            break;
+    }
+}
+
+template <> inline
+bool readText(const std::string& input, ScanCacheMode& value)
+{
+    const std::string tmp = trimCpy(input);
+    if (tmp == "Off")
+        value = ScanCacheMode::off;
+    else if (tmp == "Use")
+        value = ScanCacheMode::use;
+    else if (tmp == "Verify")
+        value = ScanCacheMode::verify;
+    else
+        return false;
+    return true;
+}
+
+
 template <> inline
 void writeText(const PostSyncAction& value, std::string& output)
 {
@@ -1340,6 +1378,18 @@ void readConfig(const XmlIn& in, MainConfiguration& mainCfg, int formatVer)
         inMain["EmailNotification"](mainCfg.emailNotifyAddress);
         inMain["EmailNotification"].attribute("Condition", mainCfg.emailNotifyCondition);
     }
+
+    //TODO: remove if parameter migration after some time! 2026-10-16
+    if (formatVer < 18)
+        ;
+    else
+        inMain["ScanCache"].attribute("Mode", mainCfg.scanCache);
+
+    //TODO: remove if parameter migration after some time! 2026-10-16
+    if (formatVer < 19)
+        ;
+    else
+        inMain["SoftFilter"].attribute("Prune", mainCfg.pruneSoftFiltered);
 }
 
 
@@ -2284,6 +2334,10 @@ void writeConfig(const MainConfiguration& mainCfg, XmlOut& out)
 
     outMain["EmailNotification"](mainCfg.emailNotifyAddress);
     outMain["EmailNotification"].attribute("Condition", mainCfg.emailNotifyCondition);
+
+    outMain["ScanCache"].attribute("Mode", mainCfg.scanCache);
+
+    outMain["SoftFilter"].attribute("Prune", mainCfg.pruneSoftFiltered);
 }
 
 
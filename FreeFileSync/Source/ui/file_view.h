@@ -132,7 +132,7 @@ private:
     template <class Predicate> void updateView(Predicate pred);
 
 
-    std::unordered_map<FileSystemObject::ObjectIdConst, size_t> rowPositions_; //find row positions on viewRef_ directly
+    std::unordered_map<FileSystemObject::ObjectIdConst, size_t, FileSystemObject::IdHash> rowPositions_; //find row positions on viewRef_ directly
     std::unordered_map<const void* /*ContainerObject*/, size_t> rowPositionsFirstChild_; //find first child on sortedRef of a hierarchy object
     //void* instead of ContainerObject*: these are weak pointers and should *never be dereferenced*!
 
@@ -337,6 +337,7 @@ protected:
     zen::ToggleButton* m_buttonByTimeSize;
     zen::ToggleButton* m_buttonByContent;
     zen::ToggleButton* m_buttonBySize;
+    zen::ToggleButton* m_buttonByHash;
     wxStaticBitmap* m_bitmapCompVariant;
     wxStaticText* m_staticTextCompVarDescription;
     wxStaticLine* m_staticline33;
@@ -499,6 +500,8 @@ protected:
     virtual void onCompByContentDouble( wxMouseEvent& event ) { event.Skip(); }
     virtual void onCompBySize( wxCommandEvent& event ) { event.Skip(); }
     virtual void onCompBySizeDouble( wxMouseEvent& event ) { event.Skip(); }
+    virtual void onCompByHash( wxCommandEvent& event ) { event.Skip(); }
+    virtual void onCompByHashDouble( wxMouseEvent& event ) { event.Skip(); }
     virtual void onChangeCompOption( wxCommandEvent& event ) { event.Skip(); }
     virtual void onToggleIgnoreErrors( wxCommandEvent& event ) { event.Skip(); }
     virtual void onToggleAutoRetry( wxCommandEvent& event ) { event.Skip(); }
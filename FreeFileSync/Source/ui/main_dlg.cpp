@@ -2858,6 +2858,7 @@ void MainDialog::onCompSettingsContext(wxEvent& event)
     addVariantItem(CompareVariant::timeSize, "cmp_time");
     addVariantItem(CompareVariant::content,  "cmp_content");
     addVariantItem(CompareVariant::size,     "cmp_size");
+    addVariantItem(CompareVariant::hash,     "cmp_content");
 
     menu.popup(*m_bpButtonCmpContext, {m_bpButtonCmpContext->GetSize().x, 0});
 }
@@ -4079,6 +4080,8 @@ void MainDialog::onCompare(wxCommandEvent& event)
                              globalCfg_.createLockFile,
                              dirLocks,
                              fpCfgList,
+                             nullptr /*changes*/,
+                             guiCfg.mainCfg.deviceParallelOps,
                              statusHandler); //throw AbortProcess
     }
     catch (AbortProcess&) {}
@@ -4161,6 +4164,7 @@ void MainDialog::updateGui()
             case CompareVariant::timeSize: cmpVarIconName = "cmp_time";    break;
             case CompareVariant::content:  cmpVarIconName = "cmp_content"; break;
             case CompareVariant::size:     cmpVarIconName = "cmp_size";    break;
+            case CompareVariant::hash:     cmpVarIconName = "cmp_content"; break;
             //*INDENT-ON*
         }
     const char* syncVarIconName = nullptr;
@@ -4252,6 +4256,7 @@ void MainDialog::applyCompareConfig(bool setDefaultViewType)
                 break;
 
             case CompareVariant::content:
+            case CompareVariant::hash:
                 setGridViewType(GridViewType::difference);
                 break;
         }
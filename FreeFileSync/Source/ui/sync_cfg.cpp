@@ -136,9 +136,11 @@ private:
     void onCompByTimeSize      (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::timeSize; updateCompGui(); updateSyncGui(); } //
     void onCompByContent       (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::content;  updateCompGui(); updateSyncGui(); } //affects sync settings, too!
     void onCompBySize          (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::size;     updateCompGui(); updateSyncGui(); } //
+    void onCompByHash          (wxCommandEvent& event) override { localCmpVar_ = CompareVariant::hash;     updateCompGui(); updateSyncGui(); } //
     void onCompByTimeSizeDouble(wxMouseEvent&   event) override;
     void onCompByContentDouble (wxMouseEvent&   event) override;
     void onCompBySizeDouble    (wxMouseEvent&   event) override;
+    void onCompByHashDouble    (wxMouseEvent&   event) override;
     void onChangeCompOption    (wxCommandEvent& event) override { updateCompGui(); }
 
     std::optional<CompConfig> getCompConfig() const;
@@ -276,6 +278,8 @@ std::wstring getCompVariantDescription(CompareVariant var)
             return _("Identify equal files by comparing the file content.");
         case CompareVariant::size:
             return _("Identify equal files by comparing their file size.");
+        case CompareVariant::hash:
+            return _("Identify equal files by comparing content hashes. Both sides are read independently.");
     }
     assert(false);
     return _("Error");
@@ -386,17 +390,20 @@ showMultipleCfgs_(showMultipleCfgs)
     setRelativeFontSize(*m_buttonByTimeSize, 1.25);
     setRelativeFontSize(*m_buttonByContent,  1.25);
     setRelativeFontSize(*m_buttonBySize,     1.25);
+    setRelativeFontSize(*m_buttonByHash,     1.25);
 
     initBitmapRadioButtons(
     {
         {m_buttonByTimeSize, "cmp_time"   },
         {m_buttonByContent,  "cmp_content"},
         {m_buttonBySize,     "cmp_size"   },
+        {m_buttonByHash,     "cmp_content"},
     }, true /*alignLeft*/);
 
     m_buttonByTimeSize->SetToolTip(getCompVariantDescription(CompareVariant::timeSize));
     m_buttonByContent ->SetToolTip(getCompVariantDescription(CompareVariant::content));
     m_buttonBySize    ->SetToolTip(getCompVariantDescription(CompareVariant::size));
+    m_buttonByHash    ->SetToolTip(getCompVariantDescription(CompareVariant::hash));
 
     m_staticTextCompVarDescription->SetMinSize({fastFromDIP(CFG_DESCRIPTION_WIDTH_DIP), -1});
 
@@ -681,6 +688,14 @@ void ConfigDialog::onCompByContentDouble(wxMouseEvent& event)
 }
 
 
+void ConfigDialog::onCompByHashDouble(wxMouseEvent& event)
+{
+    wxCommandEvent dummy;
+    onCompByHash(dummy);
+    onOkay(dummy);
+}
+
+
 std::optional<CompConfig> ConfigDialog::getCompConfig() const
 {
     if (!m_checkBoxUseLocalCmpOptions->GetValue())
@@ -739,6 +754,7 @@ void ConfigDialog::updateCompGui()
     m_buttonByTimeSize->setActive(CompareVariant::timeSize == localCmpVar_ && compOptionsEnabled);
     m_buttonByContent ->setActive(CompareVariant::content  == localCmpVar_ && compOptionsEnabled);
     m_buttonBySize    ->setActive(CompareVariant::size     == localCmpVar_ && compOptionsEnabled);
+    m_buttonByHash    ->setActive(CompareVariant::hash     == localCmpVar_ && compOptionsEnabled);
     //compOptionsEnabled: nudge wxWidgets to render inactive config state (needed on Windows, NOT on Linux!)
 
     switch (localCmpVar_) //unconditionally update image, including "local options off"
@@ -748,6 +764,7 @@ void ConfigDialog::updateCompGui()
             m_bitmapCompVariant->SetBitmap(greyScaleIfDisabled(loadImage("cmp_time"), compOptionsEnabled));
             break;
         case CompareVariant::content:
+        case CompareVariant::hash:
             m_bitmapCompVariant->SetBitmap(greyScaleIfDisabled(loadImage("cmp_content"), compOptionsEnabled));
             break;
         case CompareVariant::size:
@@ -1117,8 +1134,8 @@ void ConfigDialog::updateSyncGui()
         m_bitmapRightNewer  ->Show(activeCmpVar == CompareVariant::timeSize);
         m_bpButtonRightNewer->Show(activeCmpVar == CompareVariant::timeSize);
 
-        m_bitmapDifferent  ->Show(activeCmpVar == CompareVariant::content || activeCmpVar == CompareVariant::size);
-        m_bpButtonDifferent->Show(activeCmpVar == CompareVariant::content || activeCmpVar == CompareVariant::size);
+        m_bitmapDifferent  ->Show(activeCmpVar != CompareVariant::timeSize);
+        m_bpButtonDifferent->Show(activeCmpVar != CompareVariant::timeSize);
     }
 
     //active variant description:
@@ -0,0 +1,286 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "batch_stat.h"
+#include <cstring>
+#include "scope_guard.h"
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <linux/io_uring.h>
+
+using namespace zen;
+
+
+/* no liburing dependency: raw io_uring syscalls are sufficient for our simple usage
+    - single submitter, no SQPOLL => only need memory barriers on SQ tail/CQ head
+    - CQ ring holds twice the SQ entries by default => no CQ overflow when submitting at most "sq_entries" at a time
+    - the kernel writes statx output (and, kernel < 5.12, reads item names) asynchronously
+        => buffers are owned by Impl, NOT by the caller: they must outlive every request in flight, even when getItemDetails() throws   */
+struct BatchStatx::Impl
+{
+    ~Impl()
+    {
+        if (inFlight > 0 || unsubmitted > 0) //ring is broken: kernel may still access our buffers while tearing down => leak rather than corrupt the heap
+        {
+            new std::vector<Result>(std::move(results)); //intentional leak!
+            new std::string        (std::move(nameBuf)); //
+        }
+        if (sqes    != MAP_FAILED) ::munmap(sqes,    sqesSize);
+        if (cqRing  != MAP_FAILED && cqRing != sqRing) ::munmap(cqRing, cqRingSize);
+        if (sqRing  != MAP_FAILED) ::munmap(sqRing,  sqRingSize);
+        if (ringFd != -1) ::close(ringFd);
+    }
+
+    int ringFd = -1;
+
+    void*  sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void*  cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned int  sqEntries = 0;
+    unsigned int* sqTail  = nullptr;
+    unsigned int* sqMask  = nullptr;
+    unsigned int* sqArray = nullptr;
+
+    unsigned int*  cqHead = nullptr;
+    unsigned int*  cqTail = nullptr;
+    unsigned int*  cqMask = nullptr;
+    io_uring_cqe*  cqes   = nullptr;
+
+    //request state: consistent across calls, even after errors
+    uint32_t generation = 0;      //tag of current batch: user_data = generation << 32 | item index
+    unsigned int unsubmitted = 0; //SQEs published to the SQ ring, but not yet consumed by the kernel
+    unsigned int inFlight    = 0; //submitted, but CQE not yet reaped
+    bool broken = false;          //failed to drain requests => don't reuse ring or buffers
+
+    std::vector<Result> results;
+    std::string nameBuf; //item names, 0-terminated
+
+    size_t reapCompletions(); //noexcept
+    void drainRequests();     //noexcept
+};
+
+
+#ifdef __NR_io_uring_setup
+namespace
+{
+template <class T> inline
+T* ringPtr(void* ring, unsigned int offset) { return reinterpret_cast<T*>(static_cast<char*>(ring) + offset); }
+
+
+void* mapRing(int ringFd, size_t size, off_t offset) //throw SysError
+{
+    void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+    if (ptr == MAP_FAILED)
+        THROW_LAST_SYS_ERROR("mmap(io_uring)");
+    return ptr;
+}
+}
+
+
+BatchStatx::BatchStatx(unsigned int queueDepth) : pimpl_(std::make_unique<Impl>()) //throw SysError
+{
+    io_uring_params params = {};
+    pimpl_->ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, queueDepth, &params));
+    if (pimpl_->ringFd < 0)
+    {
+        pimpl_->ringFd = -1;
+        THROW_LAST_SYS_ERROR("io_uring_setup"); //ENOSYS: kernel < 5.1, EPERM: disabled (kernel.io_uring_disabled, seccomp)
+    }
+
+    //IORING_OP_STATX requires kernel 5.6 (same as IORING_REGISTER_PROBE)
+    {
+        const size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+        std::vector<std::byte> probeBuf(probeSize);
+        auto probe = reinterpret_cast<io_uring_probe*>(probeBuf.data());
+
+        if (::syscall(__NR_io_uring_register, pimpl_->ringFd, IORING_REGISTER_PROBE, probe, 256) < 0)
+            THROW_LAST_SYS_ERROR("io_uring_register(IORING_REGISTER_PROBE)");
+
+        if (probe->last_op < IORING_OP_STATX || !(probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED))
+            throw SysError(formatSystemError("io_uring_register(IORING_REGISTER_PROBE)", L"", L"IORING_OP_STATX is not supported."));
+    }
+
+    pimpl_->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    pimpl_->cqRingSize = params.cq_off.cqes  + params.cq_entries * sizeof(io_uring_cqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP) //kernel 5.4
+    {
+        pimpl_->sqRingSize = pimpl_->cqRingSize = std::max(pimpl_->sqRingSize, pimpl_->cqRingSize);
+        pimpl_->sqRing = pimpl_->cqRing = mapRing(pimpl_->ringFd, pimpl_->sqRingSize, IORING_OFF_SQ_RING); //throw SysError
+    }
+    else
+    {
+        pimpl_->sqRing = mapRing(pimpl_->ringFd, pimpl_->sqRingSize, IORING_OFF_SQ_RING); //throw SysError
+        pimpl_->cqRing = mapRing(pimpl_->ringFd, pimpl_->cqRingSize, IORING_OFF_CQ_RING); //
+    }
+
+    pimpl_->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    pimpl_->sqes = static_cast<io_uring_sqe*>(mapRing(pimpl_->ringFd, pimpl_->sqesSize, IORING_OFF_SQES)); //throw SysError
+
+    pimpl_->sqEntries = params.sq_entries;
+    pimpl_->sqTail  = ringPtr<unsigned int>(pimpl_->sqRing, params.sq_off.tail);
+    pimpl_->sqMask  = ringPtr<unsigned int>(pimpl_->sqRing, params.sq_off.ring_mask);
+    pimpl_->sqArray = ringPtr<unsigned int>(pimpl_->sqRing, params.sq_off.array);
+
+    pimpl_->cqHead = ringPtr<unsigned int>(pimpl_->cqRing, params.cq_off.head);
+    pimpl_->cqTail = ringPtr<unsigned int>(pimpl_->cqRing, params.cq_off.tail);
+    pimpl_->cqMask = ringPtr<unsigned int>(pimpl_->cqRing, params.cq_off.ring_mask);
+    pimpl_->cqes   = ringPtr<io_uring_cqe>(pimpl_->cqRing, params.cq_off.cqes);
+}
+
+
+//reap all available CQEs; returns number of CQEs belonging to the current batch
+size_t BatchStatx::Impl::reapCompletions() //noexcept
+{
+    size_t reaped = 0;
+    unsigned int head = *cqHead; //we're the only consumer
+    const unsigned int tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head)
+    {
+        const io_uring_cqe& cqe = cqes[head & *cqMask];
+        assert(inFlight > 0);
+        if (inFlight > 0)
+            --inFlight;
+
+        const uint32_t cqeGeneration = static_cast<uint32_t>(cqe.user_data >> 32);
+        const size_t   itemIdx       = static_cast<uint32_t>(cqe.user_data);
+
+        //don't trust user_data blindly: discard stale CQEs, e.g. from a batch that failed before draining
+        if (cqeGeneration == generation && itemIdx < results.size())
+        {
+            if (cqe.res < 0)
+                results[itemIdx].errorCode = -cqe.res;
+            ++reaped;
+        }
+        else assert(false);
+    }
+    __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+
+//submit leftover SQEs and wait until the kernel is done with all requests (and our buffers)
+void BatchStatx::Impl::drainRequests() //noexcept
+{
+    while (unsubmitted > 0 || inFlight > 0)
+    {
+        const bool submit = unsubmitted > 0 && inFlight == 0; //EAGAIN/EBUSY: don't resubmit before reaping
+        const int rv = static_cast<int>(::syscall(__NR_io_uring_enter, ringFd, submit ? unsubmitted : 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (rv < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            broken = true; //give up: keep buffers alive until ~Impl()
+            return;
+        }
+        if (submit)
+        {
+            const unsigned int submitted = std::min(static_cast<unsigned int>(rv), unsubmitted);
+            unsubmitted -= submitted;
+            inFlight    += submitted;
+        }
+        reapCompletions();
+    }
+}
+
+
+std::vector<BatchStatx::Result> BatchStatx::getItemDetails(int dirFd, const std::vector<const char*>& itemNames, int flags, unsigned int mask) //throw SysError
+{
+    Impl& ring = *pimpl_;
+    if (ring.broken)
+        throw SysError(formatSystemError("io_uring_enter", L"", L"Ring is unusable after a previous error."));
+
+    assert(ring.unsubmitted == 0 && ring.inFlight == 0);
+    ZEN_ON_SCOPE_FAIL(ring.drainRequests()); //kernel must be done with our buffers before reusing them
+
+    ++ring.generation;
+    ring.results.assign(itemNames.size(), Result());
+
+    std::vector<size_t> nameOffsets;
+    ring.nameBuf.clear();
+    for (const char* itemName : itemNames)
+    {
+        nameOffsets.push_back(ring.nameBuf.size());
+        ring.nameBuf.append(itemName);
+        ring.nameBuf += '\0';
+    }
+
+    for (size_t chunkBegin = 0; chunkBegin < itemNames.size(); chunkBegin += ring.sqEntries)
+    {
+        const size_t chunkEnd = std::min<size_t>(chunkBegin + ring.sqEntries, itemNames.size());
+
+        unsigned int sqTail = *ring.sqTail; //we're the only producer
+        for (size_t i = chunkBegin; i < chunkEnd; ++i, ++sqTail)
+        {
+            const unsigned int idx = sqTail & *ring.sqMask;
+
+            io_uring_sqe& sqe = ring.sqes[idx];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode      = IORING_OP_STATX;
+            sqe.fd          = dirFd;
+            sqe.addr        = reinterpret_cast<uintptr_t>(ring.nameBuf.c_str() + nameOffsets[i]);
+            sqe.len         = mask;
+            sqe.off         = reinterpret_cast<uintptr_t>(&ring.results[i].itemInfo);
+            sqe.statx_flags = flags;
+            sqe.user_data   = static_cast<uint64_t>(ring.generation) << 32 | i;
+
+            ring.sqArray[idx] = idx;
+        }
+        __atomic_store_n(ring.sqTail, sqTail, __ATOMIC_RELEASE);
+        ring.unsubmitted = static_cast<unsigned int>(chunkEnd - chunkBegin);
+
+        size_t pending = chunkEnd - chunkBegin;
+        while (pending > 0)
+        {
+            const int rv = static_cast<int>(::syscall(__NR_io_uring_enter, ring.ringFd, ring.unsubmitted,
+                                                      static_cast<unsigned int>(pending), IORING_ENTER_GETEVENTS, nullptr, 0));
+            if (rv < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                if (errno == EAGAIN || errno == EBUSY) //out of resources or CQ ring full: reap before resubmitting instead of spinning
+                {
+                    if (ring.inFlight == 0)
+                        THROW_LAST_SYS_ERROR("io_uring_enter");
+
+                    if (const size_t reaped = ring.reapCompletions(); reaped > 0)
+                        pending -= reaped;
+                    else //wait for at least one completion without submitting
+                        for (;;)
+                            if (::syscall(__NR_io_uring_enter, ring.ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0)
+                                break;
+                            else if (errno != EINTR)
+                                THROW_LAST_SYS_ERROR("io_uring_enter");
+                    continue;
+                }
+                THROW_LAST_SYS_ERROR("io_uring_enter");
+            }
+            const unsigned int submitted = std::min(static_cast<unsigned int>(rv), ring.unsubmitted);
+            ring.unsubmitted -= submitted;
+            ring.inFlight    += submitted;
+
+            pending -= ring.reapCompletions();
+        }
+    }
+    assert(ring.unsubmitted == 0 && ring.inFlight == 0);
+    return std::move(ring.results); //all requests completed => safe to hand out
+}
+
+#else
+BatchStatx::BatchStatx(unsigned int queueDepth) : pimpl_(std::make_unique<Impl>()) //throw SysError
+{ throw SysError(formatSystemError("io_uring_setup", L"", L"io_uring is not supported by this build.")); }
+
+std::vector<BatchStatx::Result> BatchStatx::getItemDetails(int dirFd, const std::vector<const char*>& itemNames, int flags, unsigned int mask) { return {}; }
+#endif
+
+
+BatchStatx::~BatchStatx() {}
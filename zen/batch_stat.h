@@ -0,0 +1,44 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef BATCH_STAT_H_3847520984572309485
+#define BATCH_STAT_H_3847520984572309485
+
+#include <memory>
+#include <vector>
+#include "sys_error.h"
+    #include <sys/stat.h> //statx
+
+
+namespace zen
+{
+/* get item attributes for a whole folder listing with a single syscall: io_uring + IORING_OP_STATX
+    - not available (kernel < 5.6, io_uring disabled by sysctl or seccomp filter) => constructor throws SysError: use plain statx()/fstatat() instead
+    - NOT thread-safe: use one instance per thread                                                                                             */
+class BatchStatx
+{
+public:
+    explicit BatchStatx(unsigned int queueDepth); //throw SysError
+    ~BatchStatx();
+
+    struct Result
+    {
+        int errorCode = 0; //errno-value: 0 on success
+        struct statx itemInfo = {};
+    };
+    //itemNames relative to dirFd; returns one result per item (same order)
+    std::vector<Result> getItemDetails(int dirFd, const std::vector<const char*>& itemNames, int flags, unsigned int mask); //throw SysError
+
+private:
+    BatchStatx           (const BatchStatx&) = delete;
+    BatchStatx& operator=(const BatchStatx&) = delete;
+
+    struct Impl;
+    const std::unique_ptr<Impl> pimpl_;
+};
+}
+
+#endif //BATCH_STAT_H_3847520984572309485
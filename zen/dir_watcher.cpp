@@ -126,7 +126,10 @@ std::vector<DirWatcher::Change> DirWatcher::fetchChanges(const std::function<voi
     {
         inotify_event& evt = reinterpret_cast<inotify_event&>(buffer[bytePos]);
 
-        if (evt.len != 0) //exclude case: deletion of "self", already reported by parent directory watch
+        if (evt.mask & IN_Q_OVERFLOW) //events were dropped: anything may have changed
+            output.push_back({ChangeType::update, baseDirPath_});
+
+        else if (evt.len != 0) //exclude case: deletion of "self", already reported by parent directory watch
         {
             auto it = pimpl_->watchedPaths.find(evt.wd);
             if (it != pimpl_->watchedPaths.end())
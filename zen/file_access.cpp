@@ -18,6 +18,8 @@
 
     #include <sys/vfs.h> //statfs
     #include <sys/time.h> //lutimes
+    #include <sys/ioctl.h> //ioctl
+    #include <linux/fs.h> //FICLONE
     #ifdef HAVE_SELINUX
         #include <selinux/selinux.h>
     #endif
@@ -25,6 +27,7 @@
 
     #include <fcntl.h> //open, close, AT_SYMLINK_NOFOLLOW, UTIME_OMIT
     #include <sys/stat.h>
+    #include <unistd.h> //copy_file_range
 
 using namespace zen;
 
@@ -614,6 +617,53 @@ void zen::copySymlink(const Zstring& sourcePath, const Zstring& targetPath) //th
 }
 
 
+namespace
+{
+/* let the kernel copy the file content instead of shuffling it through user-space buffers:
+    1. FICLONE:           reflink => instant copy sharing the data extents (btrfs, XFS)
+    2. copy_file_range(): in-kernel copy; server-side copy for NFS 4.2, CIFS; some file systems reflink internally
+   return false if not supported => nothing was copied: fall back to bufferedStreamCopy()   */
+bool tryCopyFileContentKernel(FileInput& fileIn, FileOutput& fileOut, uint64_t fileSize, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+{
+    if (fileSize == 0) //nothing to gain
+        return false;
+
+    if (::ioctl(fileOut.getHandle(), FICLONE, fileIn.getHandle()) == 0)
+    {
+        if (notifyUnbufferedIO) notifyUnbufferedIO(fileSize); //throw X
+        return true;
+    }
+    //EOPNOTSUPP, EXDEV, EINVAL, ...: no reason to fail, just try next option (analog to "cp --reflink=auto")
+
+    const size_t blockSize = 16 * 1024 * 1024; //limit time between notifyUnbufferedIO() calls: cancel, progress
+    uint64_t bytesCopied = 0;
+    for (;;)
+    {
+        const ssize_t bytesWritten = ::copy_file_range(fileIn.getHandle(), nullptr, fileOut.getHandle(), nullptr, blockSize, 0 /*flags*/);
+        if (bytesWritten < 0)
+        {
+            const int ec = errno; //copy before making other system calls!
+            if (ec == EINTR)
+                continue;
+
+            if (bytesCopied == 0) //file offsets unchanged => safe to fall back
+                if (ec == EXDEV || ec == ENOSYS || ec == EOPNOTSUPP || ec == EINVAL || ec == EBADF || ec == EPERM || ec == ETXTBSY)
+                    return false;
+
+            throw FileError(replaceCpy(replaceCpy(_("Cannot copy file %x to %y."), L"%x", L'\n' + fmtPath(fileIn.getFilePath())),
+                                       L"%y", L'\n' + fmtPath(fileOut.getFilePath())), formatSystemError("copy_file_range", ec));
+        }
+
+        if (bytesWritten == 0) //EOF
+            return bytesCopied != 0; //virtual files (e.g. procfs, sysfs) may report 0 bytes despite having content
+        bytesCopied += bytesWritten;
+
+        if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X
+    }
+}
+}
+
+
 FileCopyResult zen::copyNewFile(const Zstring& sourceFile, const Zstring& targetFile, //throw FileError, ErrorTargetExisting, (ErrorFileLocked), X
                                 const IoCallback& notifyUnbufferedIO /*throw X*/)
 {
@@ -643,10 +693,13 @@ FileCopyResult zen::copyNewFile(const Zstring& sourceFile, const Zstring& target
     }
     FileOutput fileOut(fdTarget, targetFile, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //pass ownership
 
-    //preallocate disk space + reduce fragmentation (perf: no real benefit)
-    fileOut.reserveSpace(sourceInfo.st_size); //throw FileError
+    if (!tryCopyFileContentKernel(fileIn, fileOut, sourceInfo.st_size, notifyUnbufferedIO)) //throw FileError, X
+    {
+        //preallocate disk space + reduce fragmentation (perf: no real benefit)
+        fileOut.reserveSpace(sourceInfo.st_size); //throw FileError
 
-    bufferedStreamCopy(fileIn, fileOut); //throw FileError, (ErrorFileLocked), X
+        bufferedStreamCopy(fileIn, fileOut); //throw FileError, (ErrorFileLocked), X
+    }
 
     //flush intermediate buffers before fiddling with the raw file handle
     fileOut.flushBuffers(); //throw FileError, X
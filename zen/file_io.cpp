@@ -13,6 +13,21 @@
 using namespace zen;
 
 
+namespace
+{
+const size_t IO_BLOCK_SIZE_MAX = 8 * 1024 * 1024; //e.g. RAID: large I/Os needed for full throughput
+}
+
+
+FileBase::FileBase(FileHandle handle, const Zstring& filePath) : hFile_(handle), filePath_(filePath)
+{
+    //file system's preferred I/O size: e.g. NFS: rsize/wsize, XFS: stripe width; but ext4 et al. report 4 KiB => too small
+    struct stat fileInfo = {};
+    if (::fstat(hFile_, &fileInfo) == 0)
+        ioBlockSizeMin_ = ioBlockSize_ = std::clamp(static_cast<size_t>(fileInfo.st_blksize), getBlockSize(), IO_BLOCK_SIZE_MAX);
+}
+
+
 FileBase::~FileBase()
 {
     if (hFile_ != invalidFileHandle)
@@ -34,6 +49,22 @@ void FileBase::close() //throw FileError
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getFilePath())), "close");
 }
 
+
+void FileBase::adaptIoBlockSize(std::chrono::steady_clock::duration ioTime)
+{
+    //analog to StreamReader::appendChunk() (binary.cpp), but grow with each fast call: file copy needs large I/Os early
+    const auto now = std::chrono::steady_clock::now();
+
+    if (ioTime >= std::chrono::milliseconds(100))
+        lastDelayViolation_ = now;
+
+    if (ioTime > std::chrono::milliseconds(500)) //keep progress updates and cancellation responsive
+        ioBlockSize_ = std::max(ioBlockSize_ / 2, ioBlockSizeMin_);
+    //avoid "flipping back": e.g. DVD-ROMs read 32MB at once, so first read may be > 500 ms, but second one will be 0ms!
+    else if (now >= lastDelayViolation_ + std::chrono::seconds(2))
+        ioBlockSize_ = std::min(ioBlockSize_ * 2, IO_BLOCK_SIZE_MAX);
+}
+
 //----------------------------------------------------------------------------------------------------
 
 namespace
@@ -93,7 +124,7 @@ size_t FileInput::tryRead(void* buffer, size_t bytesToRead) //throw FileError, E
 {
     if (bytesToRead == 0) //"read() with a count of 0 returns zero" => indistinguishable from end of file! => check!
         throw std::logic_error("Contract violation! " + std::string(__FILE__) + ':' + numberTo<std::string>(__LINE__));
-    assert(bytesToRead == getBlockSize());
+    assert(bytesToRead == getIoBlockSize());
 
     ssize_t bytesRead = 0;
     do
@@ -130,8 +161,6 @@ size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, Erro
             - replacing std::copy() with memcpy() also *seems* to have improved speed "somewhat"
     */
 
-    const size_t blockSize = getBlockSize();
-    assert(memBuf_.size() >= blockSize);
     assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
 
     auto       it    = static_cast<std::byte*>(buffer);
@@ -146,10 +175,18 @@ size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, Erro
         if (it == itEnd)
             break;
         //--------------------------------------------------------------------
+        const size_t blockSize = getIoBlockSize();
+        if (memBuf_.size() < blockSize) //buffer is empty at this point
+            memBuf_.resize(blockSize);
+
+        const auto startTime = std::chrono::steady_clock::now();
         const size_t bytesRead = tryRead(&memBuf_[0], blockSize); //throw FileError, ErrorFileLocked; may return short, only 0 means EOF! => CONTRACT: bytesToRead > 0
         bufPos_ = 0;
         bufPosEnd_ = bytesRead;
 
+        if (bytesRead == blockSize) //don't adapt for short reads, e.g. end of file
+            adaptIoBlockSize(std::chrono::steady_clock::now() - startTime);
+
         if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesRead); //throw X
 
         if (bytesRead == 0) //end of file
@@ -216,7 +253,7 @@ size_t FileOutput::tryWrite(const void* buffer, size_t bytesToWrite) //throw Fil
 {
     if (bytesToWrite == 0)
         throw std::logic_error("Contract violation! " + std::string(__FILE__) + ':' + numberTo<std::string>(__LINE__));
-    assert(bytesToWrite <= getBlockSize());
+    assert(bytesToWrite <= getIoBlockSize());
 
     ssize_t bytesWritten = 0;
     do
@@ -243,7 +280,7 @@ size_t FileOutput::tryWrite(const void* buffer, size_t bytesToWrite) //throw Fil
 
 void FileOutput::write(const void* buffer, size_t bytesToWrite) //throw FileError, X
 {
-    const size_t blockSize = getBlockSize();
+    size_t blockSize = getIoBlockSize();
     assert(memBuf_.size() >= blockSize);
     assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
 
@@ -267,8 +304,18 @@ void FileOutput::write(const void* buffer, size_t bytesToWrite) //throw FileErro
         if (it == itEnd)
             return;
         //--------------------------------------------------------------------
+        const auto startTime = std::chrono::steady_clock::now();
         const size_t bytesWritten = tryWrite(&memBuf_[bufPos_], blockSize); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
         bufPos_ += bytesWritten;
+
+        if (bytesWritten == blockSize) //buffer is empty => safe to change block size
+        {
+            adaptIoBlockSize(std::chrono::steady_clock::now() - startTime);
+            blockSize = getIoBlockSize();
+            if (memBuf_.size() < blockSize)
+                memBuf_.resize(blockSize);
+        }
+
         if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesWritten); //throw X!
     }
 }
@@ -276,7 +323,7 @@ void FileOutput::write(const void* buffer, size_t bytesToWrite) //throw FileErro
 
 void FileOutput::flushBuffers() //throw FileError, X
 {
-    assert(bufPosEnd_ - bufPos_ <= getBlockSize());
+    assert(bufPosEnd_ - bufPos_ <= getIoBlockSize());
     assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
     while (bufPos_ != bufPosEnd_)
     {
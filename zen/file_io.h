@@ -7,6 +7,7 @@
 #ifndef FILE_IO_H_89578342758342572345
 #define FILE_IO_H_89578342758342572345
 
+#include <chrono>
 #include "file_error.h"
 #include "file_access.h"
 #include "serialize.h"
@@ -32,23 +33,31 @@ public:
     FileHandle getHandle() { return hFile_; }
 
     //Windows: use 64kB ?? https://docs.microsoft.com/en-us/previous-versions/windows/it-pro/windows-2000-server/cc938632%28v=technet.10%29
-    //macOS, Linux: use st_blksize?
+    //block size for stream users; size of native read()/write() calls is dynamic: see getIoBlockSize()
     static size_t getBlockSize() { return 128 * 1024; };
 
     const Zstring& getFilePath() const { return filePath_; }
 
 protected:
-    FileBase(FileHandle handle, const Zstring& filePath) : hFile_(handle), filePath_(filePath) {}
+    FileBase(FileHandle handle, const Zstring& filePath);
     ~FileBase();
 
     void close(); //throw FileError -> optional, but good place to catch errors when closing stream!
 
+    //start with st_blksize (if larger than getBlockSize()), grow while native I/O calls stay fast
+    size_t getIoBlockSize() const { return ioBlockSize_; }
+    void adaptIoBlockSize(std::chrono::steady_clock::duration ioTime); //call after each *full-size* I/O
+
 private:
     FileBase           (const FileBase&) = delete;
     FileBase& operator=(const FileBase&) = delete;
 
     FileHandle hFile_ = invalidFileHandle;
     const Zstring filePath_;
+
+    size_t ioBlockSizeMin_ = getBlockSize();
+    size_t ioBlockSize_    = getBlockSize();
+    std::chrono::steady_clock::time_point lastDelayViolation_; //= clock epoch: grow right away
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -66,7 +75,7 @@ private:
 
     const IoCallback notifyUnbufferedIO_; //throw X
 
-    std::vector<std::byte> memBuf_ = std::vector<std::byte>(getBlockSize());
+    std::vector<std::byte> memBuf_ = std::vector<std::byte>(getIoBlockSize());
     size_t bufPos_   = 0;
     size_t bufPosEnd_= 0;
 };
@@ -91,7 +100,7 @@ private:
     size_t tryWrite(const void* buffer, size_t bytesToWrite); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
 
     IoCallback notifyUnbufferedIO_; //throw X
-    std::vector<std::byte> memBuf_ = std::vector<std::byte>(getBlockSize());
+    std::vector<std::byte> memBuf_ = std::vector<std::byte>(getIoBlockSize());
     size_t bufPos_    = 0;
     size_t bufPosEnd_ = 0;
 };
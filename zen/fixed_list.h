@@ -10,6 +10,7 @@
 #include <cassert>
 #include <iterator>
 #include "stl_tools.h"
+#include "string_tools.h"
 
 
 namespace zen
@@ -235,6 +236,151 @@ private:
 
     std::vector<std::unique_ptr<T>> items_;
 };
+
+//std::list-like: no iterator invalidation after emplace_back(), but elements are stored in blocks of exponentially growing size
+//=> one allocation per block instead of per element + CPU-cache-friendly iteration => superseeds FixedList for large containers
+//remove_if(): elements are non-movable => leaves holes (skipped during iteration and never reused), empty blocks are released
+template <class T>
+class FixedBlockList
+{
+    static constexpr size_t BLOCK_SIZE_MIN = 4; //most folders are small
+    static constexpr size_t BLOCK_SIZE_MAX = 256;
+
+    struct Block
+    {
+        explicit Block(size_t cap) : rawMem(std::make_unique<std::byte[]>(cap * (sizeof(T) + sizeof(bool)))), capacity(cap) {}
+
+        T*    items() const { static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__); return reinterpret_cast<T*>(rawMem.get()); }
+        bool* alive() const { return reinterpret_cast<bool*>(rawMem.get() + capacity * sizeof(T)); } //T[capacity] followed by bool[capacity]
+
+        std::unique_ptr<std::byte[]> rawMem;
+        size_t capacity  = 0;
+        size_t used      = 0; //elements constructed, including removed ones
+        size_t aliveCount = 0;
+    };
+
+public:
+    FixedBlockList() {}
+
+    ~FixedBlockList() { clear(); }
+
+    template <class Blocks, class Value>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = ptrdiff_t;
+        using pointer   = Value*;
+        using reference = Value&;
+
+        Iterator() {} //end()
+        Iterator(Blocks& blocks, size_t blockIdx, size_t pos) : blocks_(&blocks), blockIdx_(blockIdx), pos_(pos) { skipRemoved(); }
+        Iterator& operator++() { ++pos_; skipRemoved(); return *this; }
+        inline friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.blockIdx_ == rhs.blockIdx_ && lhs.pos_ == rhs.pos_; }
+        Value& operator* () const { return  (*blocks_)[blockIdx_].items()[pos_]; }
+        Value* operator->() const { return &(*blocks_)[blockIdx_].items()[pos_]; }
+    private:
+        void skipRemoved()
+        {
+            for (; blockIdx_ < blocks_->size(); ++blockIdx_, pos_ = 0)
+                for (const Block& block = (*blocks_)[blockIdx_]; pos_ < block.used; ++pos_)
+                    if (block.alive()[pos_])
+                        return;
+            *this = Iterator(); //end() must not depend on container size: no invalidation after emplace_back()
+        }
+
+        Blocks* blocks_ = nullptr;
+        size_t blockIdx_ = static_cast<size_t>(-1);
+        size_t pos_ = 0;
+    };
+
+    using value_type      = T;
+    using iterator        = Iterator<      std::vector<Block>,       T>;
+    using const_iterator  = Iterator<const std::vector<Block>, const T>;
+    using reference       =       T&;
+    using const_reference = const T&;
+
+    iterator begin() { return {blocks_, 0, 0}; }
+    iterator end  () { return {}; }
+
+    const_iterator begin() const { return {blocks_, 0, 0}; }
+    const_iterator end  () const { return {}; }
+
+    reference       front()       { return *begin(); }
+    const_reference front() const { return *begin(); }
+
+    reference back() { return const_cast<T&>(static_cast<const FixedBlockList*>(this)->back()); }
+    const_reference back() const
+    {
+        assert(!empty());
+        for (auto it = blocks_.rbegin(); it != blocks_.rend(); ++it) //usually last block, last element
+            for (size_t pos = it->used; pos-- > 0;)
+                if (it->alive()[pos])
+                    return it->items()[pos];
+        throw std::logic_error("Contract violation! " + std::string(__FILE__) + ':' + numberTo<std::string>(__LINE__));
+    }
+
+    template <class... Args>
+    T& emplace_back(Args&& ... args)
+    {
+        if (blocks_.empty() || blocks_.back().used == blocks_.back().capacity)
+            blocks_.emplace_back(blocks_.empty() ? BLOCK_SIZE_MIN : std::min(2 * blocks_.back().capacity, BLOCK_SIZE_MAX));
+
+        Block& block = blocks_.back();
+        T* newItem = ::new (block.items() + block.used) T(std::forward<Args>(args)...); //throw ?
+
+        block.alive()[block.used++] = true;
+        ++block.aliveCount;
+        ++sz_;
+        return *newItem;
+    }
+
+    template <class Predicate>
+    void remove_if(Predicate pred)
+    {
+        for (Block& block : blocks_)
+            for (size_t pos = 0; pos < block.used; ++pos)
+                if (block.alive()[pos] && pred(block.items()[pos]))
+                {
+                    block.items()[pos].~T();
+                    block.alive()[pos] = false;
+                    --block.aliveCount;
+                    assert(sz_ > 0);
+                    --sz_;
+                }
+
+        std::erase_if(blocks_, [](const Block& block) { return block.aliveCount == 0; });
+    }
+
+    void clear()
+    {
+        for (Block& block : blocks_)
+            for (size_t pos = 0; pos < block.used; ++pos)
+                if (block.alive()[pos])
+                    block.items()[pos].~T();
+
+        blocks_.clear();
+        sz_ = 0;
+    }
+
+    bool empty() const { return sz_ == 0; }
+
+    size_t size() const { return sz_; }
+
+    void swap(FixedBlockList& other)
+    {
+        blocks_.swap(other.blocks_);
+        std::swap(sz_, other.sz_);
+    }
+
+private:
+    FixedBlockList           (const FixedBlockList&) = delete;
+    FixedBlockList& operator=(const FixedBlockList&) = delete;
+
+    std::vector<Block> blocks_;
+    size_t sz_ = 0;
+};
 }
 
 #endif //FIXED_LIST_H_01238467085684139453534
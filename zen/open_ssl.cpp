@@ -485,6 +485,59 @@ std::wstring formatX509ErrorCode(long ec)
 }
 }
 
+class Sha256::Impl
+{
+public:
+    Impl() //throw SysError
+    {
+        mdctx_ = ::EVP_MD_CTX_create();
+        if (!mdctx_)
+            throw SysError(formatSystemError("EVP_MD_CTX_create", L"", L"Unexpected failure.")); //no more error details
+        ZEN_ON_SCOPE_FAIL(::EVP_MD_CTX_destroy(mdctx_));
+
+        if (::EVP_DigestInit_ex(mdctx_,        //EVP_MD_CTX* ctx
+                                EVP_sha256(),  //const EVP_MD* type
+                                nullptr) != 1) //ENGINE* impl
+            throw SysError(formatLastOpenSSLError("EVP_DigestInit_ex"));
+    }
+
+    ~Impl() { ::EVP_MD_CTX_destroy(mdctx_); }
+
+    void update(const void* buffer, size_t bytes) //throw SysError
+    {
+        if (::EVP_DigestUpdate(mdctx_, buffer, bytes) != 1)
+            throw SysError(formatLastOpenSSLError("EVP_DigestUpdate"));
+    }
+
+    Digest finalize() //throw SysError
+    {
+        Digest digest{};
+        unsigned int digestLen = 0;
+        if (::EVP_DigestFinal_ex(mdctx_,           //EVP_MD_CTX* ctx
+                                 digest.data(),    //unsigned char* md
+                                 &digestLen) != 1) //unsigned int* s
+            throw SysError(formatLastOpenSSLError("EVP_DigestFinal_ex"));
+
+        if (digestLen != digest.size())
+            throw SysError(formatSystemError("EVP_DigestFinal_ex", L"", L"Unexpected digest length."));
+        return digest;
+    }
+
+private:
+    Impl           (const Impl&) = delete;
+    Impl& operator=(const Impl&) = delete;
+
+    EVP_MD_CTX* mdctx_ = nullptr;
+};
+
+
+zen::Sha256::Sha256() : pimpl_(std::make_unique<Impl>()) {} //throw SysError
+zen::Sha256::~Sha256() {}
+void zen::Sha256::update(const void* buffer, size_t bytes) { pimpl_->update(buffer, bytes); } //throw SysError
+Sha256::Digest zen::Sha256::finalize() { return pimpl_->finalize(); } //throw SysError
+
+//================================================================================
+
 class TlsContext::Impl
 {
 public:
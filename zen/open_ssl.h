@@ -7,6 +7,7 @@
 #ifndef OPEN_SSL_H_801974580936508934568792347506
 #define OPEN_SSL_H_801974580936508934568792347506
 
+#include <array>
 #include <zen/zstring.h>
 #include <zen/sys_error.h>
 
@@ -38,6 +39,27 @@ bool isPuttyKeyStream(const std::string& keyStream);
 std::string convertPuttyKeyToPkix(const std::string& keyStream, const std::string& passphrase); //throw SysError
 
 
+//incremental SHA-256: feed data in chunks of arbitrary size
+class Sha256
+{
+public:
+    using Digest = std::array<unsigned char, 32>;
+
+    Sha256(); //throw SysError
+    ~Sha256();
+
+    void update(const void* buffer, size_t bytes); //throw SysError
+    Digest finalize(); //throw SysError; call at most once
+
+private:
+    Sha256           (const Sha256&) = delete;
+    Sha256& operator=(const Sha256&) = delete;
+
+    class Impl;
+    const std::unique_ptr<Impl> pimpl_;
+};
+
+
 class TlsContext
 {
 public:
@@ -8,22 +8,124 @@
 #include <stdexcept>
 #include "utf.h"
 
+#ifdef __SSE2__ //x86-64: always available => no runtime CPU dispatch needed
+    #include <emmintrin.h>
+#endif
+
     #include <glib.h>
     #include "sys_error.h"
 
 using namespace zen;
 
 
+namespace
+{
+/* ASCII fast paths: called for *every* item name during comparison
+    - SSE2: 16 chars per step; remainder (and non-x86 builds) scalar
+    - AVX2 not worth it: item names are usually shorter than 32 chars + would need runtime CPU dispatch */
+#ifdef __SSE2__
+inline __m128i loadChars(const char* str) { return ::_mm_loadu_si128(reinterpret_cast<const __m128i*>(str)); }
+
+inline __m128i isAsciiLower16(__m128i chars)
+{
+    //non-ASCII chars are negative as signed char => never in range [a, z]
+    return ::_mm_and_si128(::_mm_cmpgt_epi8(chars, ::_mm_set1_epi8('a' - 1)),
+                           ::_mm_cmplt_epi8(chars, ::_mm_set1_epi8('z' + 1)));
+}
+
+inline __m128i asciiToUpper16(__m128i chars)
+{
+    return ::_mm_sub_epi8(chars, ::_mm_and_si128(isAsciiLower16(chars), ::_mm_set1_epi8('a' - 'A')));
+}
+#endif
+
+
+bool isAsciiStringFast(const char* str, size_t len)
+{
+#ifdef __SSE2__
+    if (len >= 16)
+    {
+        const char* const strLast = str + len - 16;
+        for (; str < strLast; str += 16)
+            if (::_mm_movemask_epi8(loadChars(str)) != 0) //high bit set
+                return false;
+        return ::_mm_movemask_epi8(loadChars(strLast)) == 0; //overlapping last block
+    }
+#endif
+    return std::all_of(str, str + len, [](char c) { return isAsciiChar(c); });
+}
+
+
+bool hasAsciiLowerFast(const char* str, size_t len)
+{
+#ifdef __SSE2__
+    if (len >= 16)
+    {
+        const char* const strLast = str + len - 16;
+        for (; str < strLast; str += 16)
+            if (::_mm_movemask_epi8(isAsciiLower16(loadChars(str))) != 0)
+                return true;
+        return ::_mm_movemask_epi8(isAsciiLower16(loadChars(strLast))) != 0; //overlapping last block
+    }
+#endif
+    return std::any_of(str, str + len, [](char c) { return 'a' <= c && c <= 'z'; });
+}
+
+
+void asciiToUpperFast(char* str, size_t len) //in-place
+{
+#ifdef __SSE2__
+    if (len >= 16)
+    {
+        char* const strLast = str + len - 16;
+        for (; str < strLast; str += 16)
+            ::_mm_storeu_si128(reinterpret_cast<__m128i*>(str), asciiToUpper16(loadChars(str)));
+
+        ::_mm_storeu_si128(reinterpret_cast<__m128i*>(strLast), asciiToUpper16(loadChars(strLast))); //overlapping last block: to-upper is idempotent
+        return;
+    }
+#endif
+    std::for_each(str, str + len, [](char& c) { c = asciiToUpper(c); });
+}
+
+
+//skip common prefix of ASCII chars that are equal ignoring case: at least up to the first difference or non-ASCII char
+size_t getEqualAsciiNoCasePrefix(const char* lhs, const char* rhs, size_t len)
+{
+    size_t pos = 0;
+#ifdef __SSE2__
+    for (; pos + 16 <= len; pos += 16)
+    {
+        const __m128i charsL = loadChars(lhs + pos);
+        const __m128i charsR = loadChars(rhs + pos);
+
+        if (::_mm_movemask_epi8(::_mm_or_si128(charsL, charsR)) != 0) //non-ASCII: let caller decode
+            return pos;
+
+        if (::_mm_movemask_epi8(::_mm_cmpeq_epi8(asciiToUpper16(charsL), asciiToUpper16(charsR))) != 0xffff)
+            return pos;
+    }
+#endif
+    for (; pos < len; ++pos)
+        if (!isAsciiChar(lhs[pos]) || asciiToUpper(lhs[pos]) != asciiToUpper(rhs[pos]))
+            break;
+    return pos;
+}
+}
+
+
 Zstring getUpperCase(const Zstring& str)
 {
     assert(str.find(Zchar('\0')) == Zstring::npos); //don't expect embedded nulls!
 
     //fast pre-check:
-    if (isAsciiString(str)) //perf: in the range of 3.5ns
+    if (isAsciiStringFast(str.c_str(), str.size())) //perf: in the range of 3.5ns
     {
+        if (!hasAsciiLowerFast(str.c_str(), str.size()))
+            return str; //ref-counted: no allocation, e.g. upper-case names on FAT or Windows shares
+
         Zstring output = str;
-        for (Zchar& c : output)
-            c = asciiToUpper(c);
+        asciiToUpperFast(output.begin(), output.size());
         return output;
     }
 
@@ -52,7 +154,7 @@ Zstring getUpperCase(const Zstring& str)
 Zstring getUnicodeNormalForm(const Zstring& str)
 {
     //fast pre-check:
-    if (isAsciiString(str)) //perf: in the range of 3.5ns
+    if (isAsciiStringFast(str.c_str(), str.size())) //perf: in the range of 3.5ns
         return str;
     static_assert(std::is_same_v<decltype(str), const Zbase<Zchar>&>, "god bless our ref-counting! => save output string memory consumption!");
 
@@ -143,6 +245,11 @@ std::weak_ordering compareNoCaseUtf8(const char* lhs, size_t lhsLen, const char*
     //- wcsncasecmp: https://opensource.apple.com/source/Libc/Libc-763.12/string/wcsncasecmp-fbsd.c
     // => re-implement comparison based on g_unichar_tolower() to avoid memory allocations
 
+    //ASCII chars are single-byte code points: g_unichar_toupper() == asciiToUpper() => skip equal prefix without decoding
+    const size_t prefixLen = getEqualAsciiNoCasePrefix(lhs, rhs, std::min(lhsLen, rhsLen));
+    lhs += prefixLen, lhsLen -= prefixLen;
+    rhs += prefixLen, rhsLen -= prefixLen;
+
     UtfDecoder<char> decL(lhs, lhsLen);
     UtfDecoder<char> decR(rhs, rhsLen);
     for (;;)